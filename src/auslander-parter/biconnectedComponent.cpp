@@ -43,35 +43,64 @@ const SubGraph* BiconnectedComponentsHandler::getComponent(const int index) cons
 }
 
 /**
- * @brief Constructs a subgraph component from the given nodes and edges.
+ * @brief Checks if a node of the graph is a cut vertex.
  *
- * This function creates a new SubGraph object using the provided list of nodes and edges.
- * It maps the nodes from the original graph to the new subgraph and adds the corresponding edges.
+ * @param nodeIndex The index of the node in the original graph.
+ * @return true if removing the node disconnects its connected component, false otherwise.
+ */
+bool BiconnectedComponentsHandler::isCutVertex(const int nodeIndex) const {
+    return isCutVertex_m[nodeIndex];
+}
+
+/**
+ * @brief Returns the cut vertices of the graph.
+ *
+ * @return const std::vector<int>& The indices of the cut vertices, in increasing order.
+ */
+const std::vector<int>& BiconnectedComponentsHandler::getCutVertices() const {
+    return cutVertices_m;
+}
+
+/**
+ * @brief Constructs a subgraph component from the top of the node and edge stacks.
+ *
+ * This function creates a new SubGraph object using the nodes and the edges on the stacks
+ * from the given positions to the top. It maps the nodes from the original graph to the new
+ * subgraph and adds the corresponding edges.
  * 
  * @note Assumes each edge node is in nodes list
+ * The node indices are remapped through a buffer shared by all the components, so the
+ * cost is linear in the size of the component.
  *
- * @param nodes A list of pointers to the nodes that will be included in the subgraph.
- * @param edges A list of pairs of pointers to nodes representing the edges that will be included in the subgraph.
+ * @param stackOfNodes The stack of node indices, whose top holds the nodes of the component.
+ * @param firstNode The position in stackOfNodes of the first node of the component.
+ * @param stackOfEdges The stack of edges, whose top holds the edges of the component.
+ * @param firstEdge The position in stackOfEdges of the first edge of the component.
  * @return A pointer to the newly created SubGraph component.
  */
-SubGraph* BiconnectedComponentsHandler::buildComponent(std::list<const Node*>& nodes,
-std::list<std::pair<const Node*, const Node*>>& edges) {
-    SubGraph* component = new SubGraph(nodes.size(), originalGraph_m);
-    int oldToNewNodes[originalGraph_m->size()];
+SubGraph* BiconnectedComponentsHandler::buildComponent(const std::vector<int>& stackOfNodes, const int firstNode,
+const std::vector<std::pair<int, int>>& stackOfEdges, const int firstEdge) {
+    SubGraph* component = new SubGraph(stackOfNodes.size()-firstNode, originalGraph_m);
     int newIndex = 0;
-    for (const Node* node : nodes) {
-        int oldIndex = node->getIndex();
-        oldToNewNodes[node->getIndex()] = newIndex;
+    for (int i = firstNode; i < stackOfNodes.size(); ++i) {
+        int oldIndex = stackOfNodes[i];
+        oldToNewNodes_m[oldIndex] = newIndex;
         const Node* nodeComponent = component->getNode(newIndex);
         const Node* nodeOriginalGraph = originalGraph_m->getNode(oldIndex);
         component->setOriginalNode(nodeComponent, nodeOriginalGraph);
         ++newIndex;
     }
-    for (std::pair<const Node*, const Node*>& edge: edges) {
-        int fromIndex = oldToNewNodes[edge.first->getIndex()];
-        int toIndex = oldToNewNodes[edge.second->getIndex()];
-        component->addEdge(fromIndex, toIndex);
+    componentEdges_m.clear();
+    for (int i = firstEdge; i < stackOfEdges.size(); ++i) {
+        int fromIndex = oldToNewNodes_m[stackOfEdges[i].first];
+        int toIndex = oldToNewNodes_m[stackOfEdges[i].second];
+        assert(fromIndex != -1 && toIndex != -1);
+        componentEdges_m.push_back(std::make_pair(fromIndex, toIndex));
     }
+    component->compactFromEdges(componentEdges_m);
+    // resetting only the entries of the remap buffer used by this component
+    for (int i = firstNode; i < stackOfNodes.size(); ++i)
+        oldToNewNodes_m[stackOfNodes[i]] = -1;
     return component;
 }
 
@@ -85,94 +114,121 @@ std::list<std::pair<const Node*, const Node*>>& edges) {
  */
 BiconnectedComponentsHandler::BiconnectedComponentsHandler(const Graph* graph) : originalGraph_m(graph) {
     int graphSize = graph->size();
-    for (int i = 0; i < graphSize; ++i)
-        isCutVertex_m.push_back(false);
-    int nodeId[graphSize];
-    const Node* prevOfNode[graphSize];
-    int lowPoint[graphSize];
-    for (int i = 0; i < graphSize; ++i) {
-        nodeId[i] = -1;
-        prevOfNode[i] = nullptr;
-        lowPoint[i] = -1;
-    }
+    isCutVertex_m.assign(graphSize, false);
+    oldToNewNodes_m.assign(graphSize, -1);
+    std::vector<int> nodeId(graphSize, -1);
+    std::vector<int> prevOfNode(graphSize, -1);
+    std::vector<int> lowPoint(graphSize, -1);
     int nextIdToAssign = 0;
-    std::list<const Node*> stackOfNodes{};
-    std::list<std::pair<const Node*, const Node*>> stackOfEdges{};
+    std::vector<int> stackOfNodes{};
+    std::vector<std::pair<int, int>> stackOfEdges{};
+    stackOfNodes.reserve(graphSize);
     for (int i = 0; i < graphSize; i++)
         if (nodeId[i] == -1) // node not visited
-            dfsBicCom(graph->getNode(i), nodeId, prevOfNode, nextIdToAssign, lowPoint, stackOfNodes, stackOfEdges);
+            dfsBicCom(i, nodeId, prevOfNode, nextIdToAssign, lowPoint, stackOfNodes, stackOfEdges);
     assert(stackOfNodes.size() == 0);
     assert(stackOfEdges.size() == 0);
     for (int node = 0; node < graph->size(); ++node)
         if (isCutVertex_m[node]) cutVertices_m.push_back(node);
 }
 
+/**
+ * @struct DfsFrame
+ * @brief A node of the current DFS path, with the position of the next neighbor to explore.
+ */
+struct DfsFrame {
+    int node;
+    int nextNeighborPosition;
+    int childrenNumber;
+};
+
 /**
  * @brief Performs a Depth-First Search (DFS) to find biconnected components in a graph.
  *
  * This function is a part of the BiconnectedComponentsHandler class and is used to identify
  * biconnected components within a graph. It uses DFS traversal to explore the graph and 
  * determine the low points and articulation points (cut vertices).
+ * The DFS is iterative: the current path is kept in an explicit stack of frames. Tree and back
+ * edges are pushed on the edge stack and visited nodes on the node stack; when the subtree of a
+ * child closes a biconnected component, its nodes and edges are popped from the top of the stacks.
  *
- * @param node The current node being visited.
- * @param nodeId Array storing the discovery times of nodes.
- * @param prevOfNode Array storing the parent nodes in the DFS tree.
+ * @param root The index of the node the DFS starts from.
+ * @param nodeId Vector storing the discovery times of nodes.
+ * @param prevOfNode Vector storing the index of the parent of each node in the DFS tree (-1 for roots).
  * @param nextIdToAssign Reference to the next discovery time to assign.
- * @param lowPoint Array storing the lowest discovery time reachable from each node.
+ * @param lowPoint Vector storing the lowest discovery time reachable from each node.
  * @param stackOfNodes Stack of nodes used to build biconnected components.
  * @param stackOfEdges Stack of edges used to build biconnected components.
  */
-void BiconnectedComponentsHandler::dfsBicCom(const Node* node, int nodeId[],
-const Node* prevOfNode[], int& nextIdToAssign, int lowPoint[], std::list<const Node*>& stackOfNodes,
-std::list<std::pair<const Node*, const Node*>>& stackOfEdges) {
-    int nodeIndex = node->getIndex();
-    nodeId[nodeIndex] = nextIdToAssign;
-    lowPoint[nodeIndex] = nextIdToAssign;
+void BiconnectedComponentsHandler::dfsBicCom(const int root, std::vector<int>& nodeId,
+std::vector<int>& prevOfNode, int& nextIdToAssign, std::vector<int>& lowPoint, std::vector<int>& stackOfNodes,
+std::vector<std::pair<int, int>>& stackOfEdges) {
+    std::vector<DfsFrame> frames{};
+    // position of each tree edge (parent, node) on the edge stack, and of node on the node stack
+    std::vector<std::pair<int, int>> framesStackPositions{};
+    nodeId[root] = nextIdToAssign;
+    lowPoint[root] = nextIdToAssign;
     ++nextIdToAssign;
-    int childrenNumber = 0;
-    for (const Node* neighbor : node->getNeighbors()) {
-        int neighborIndex = neighbor->getIndex();
-        if (prevOfNode[nodeIndex] == neighbor)
-            continue;
-        if (nodeId[neighborIndex] == -1) { // means node is not visited
-            std::list<const Node*> newStackOfNodes{};
-            std::list<std::pair<const Node*, const Node*>> newStackOfEdges{};
-            ++childrenNumber;
-            prevOfNode[neighborIndex] = node;
-            newStackOfNodes.push_back(neighbor);
-            newStackOfEdges.push_back(std::make_pair(node, neighbor));
-            dfsBicCom(neighbor, nodeId, prevOfNode, nextIdToAssign, lowPoint, newStackOfNodes, newStackOfEdges);
-            if (lowPoint[neighborIndex] < lowPoint[nodeIndex])
-                lowPoint[nodeIndex] = lowPoint[neighborIndex];
-            if (lowPoint[neighborIndex] >= nodeId[nodeIndex]) {
-                newStackOfNodes.push_back(node);
-                const SubGraph* component = buildComponent(newStackOfNodes, newStackOfEdges);
-                components_m.push_back(std::unique_ptr<const SubGraph>(component));
-                if (prevOfNode[nodeIndex] != nullptr) // the root needs to be handled differently
-                    // (handled at end of function)
-                    isCutVertex_m[nodeIndex] = true;
+    frames.push_back(DfsFrame{root, 0, 0});
+    framesStackPositions.push_back(std::make_pair(stackOfEdges.size(), stackOfNodes.size()));
+    while (!frames.empty()) {
+        DfsFrame& frame = frames.back();
+        const int nodeIndex = frame.node;
+        const NeighborsRange neighbors = originalGraph_m->getNode(nodeIndex)->getNeighbors();
+        if (frame.nextNeighborPosition < neighbors.size()) {
+            const int neighborIndex = neighbors.getIndex(frame.nextNeighborPosition);
+            ++frame.nextNeighborPosition;
+            if (prevOfNode[nodeIndex] == neighborIndex)
+                continue;
+            if (nodeId[neighborIndex] == -1) { // means node is not visited
+                ++frame.childrenNumber;
+                prevOfNode[neighborIndex] = nodeIndex;
+                framesStackPositions.push_back(std::make_pair(stackOfEdges.size(), stackOfNodes.size()));
+                stackOfNodes.push_back(neighborIndex);
+                stackOfEdges.push_back(std::make_pair(nodeIndex, neighborIndex));
+                nodeId[neighborIndex] = nextIdToAssign;
+                lowPoint[neighborIndex] = nextIdToAssign;
+                ++nextIdToAssign;
+                frames.push_back(DfsFrame{neighborIndex, 0, 0});
             }
-            else {
-                stackOfNodes.splice(stackOfNodes.end(), newStackOfNodes);
-                stackOfEdges.splice(stackOfEdges.end(), newStackOfEdges);
+            else { // node got already visited
+                int neighborNodeId = nodeId[neighborIndex];
+                if (neighborNodeId < nodeId[nodeIndex]) {
+                    stackOfEdges.push_back(std::make_pair(nodeIndex, neighborIndex));
+                    if (neighborNodeId < lowPoint[nodeIndex])
+                        lowPoint[nodeIndex] = neighborNodeId;
+                }
             }
+            continue;
         }
-        else { // node got already visited
-            int neighborNodeId = nodeId[neighborIndex];
-            if (neighborNodeId < nodeId[nodeIndex]) {
-                stackOfEdges.push_back(std::make_pair(node, neighbor));
-                if (neighborNodeId < lowPoint[nodeIndex])
-                    lowPoint[nodeIndex] = neighborNodeId;
+        // all the neighbors of the node have been explored
+        const int childrenNumber = frame.childrenNumber;
+        const std::pair<int, int> stackPositions = framesStackPositions.back();
+        frames.pop_back();
+        framesStackPositions.pop_back();
+        if (frames.empty()) { // handling of node with no parents (the root)
+            if (childrenNumber >= 2)
+                isCutVertex_m[nodeIndex] = true;
+            else if (childrenNumber == 0) { // node is isolated
+                SubGraph* component = new SubGraph(1, originalGraph_m);
+                component->setOriginalNode(component->getNode(0), originalGraph_m->getNode(nodeIndex));
+                components_m.push_back(std::unique_ptr<const SubGraph>(component));
             }
+            continue;
         }
-    }
-    if (prevOfNode[nodeIndex] == nullptr) { // handling of node with no parents (the root)
-        if (childrenNumber >= 2)
-            isCutVertex_m[nodeIndex] = true;
-        else if (childrenNumber == 0) { // node is isolated
-            SubGraph* component = new SubGraph(1, originalGraph_m);
-            component->setOriginalNode(0, node);
+        const int parentIndex = frames.back().node;
+        if (lowPoint[nodeIndex] < lowPoint[parentIndex])
+            lowPoint[parentIndex] = lowPoint[nodeIndex];
+        if (lowPoint[nodeIndex] >= nodeId[parentIndex]) {
+            stackOfNodes.push_back(parentIndex);
+            const SubGraph* component = buildComponent(stackOfNodes, stackPositions.second,
+                stackOfEdges, stackPositions.first);
             components_m.push_back(std::unique_ptr<const SubGraph>(component));
+            stackOfNodes.resize(stackPositions.second);
+            stackOfEdges.resize(stackPositions.first);
+            if (prevOfNode[parentIndex] != -1) // the root needs to be handled differently
+                // (handled when its frame is popped)
+                isCutVertex_m[parentIndex] = true;
         }
     }
 }
@@ -2,7 +2,6 @@
 #define MY_BICONNECTED_COMPONENT_H
 
 #include <vector>
-#include <list>
 #include <utility>
 #include <memory>
 
@@ -14,6 +13,10 @@
  *
  * This class is responsible for identifying and managing biconnected components
  * within a given graph. It uses the Tarjan's algorithm to identify the components in O(n+m).
+ * The depth-first search is iterative, with explicit stacks of DFS frames, nodes and edges
+ * kept in vectors, so it handles arbitrarily deep DFS trees (e.g. very long paths).
+ * The components are extracted through scratch buffers shared by all of them, whose
+ * touched entries only are reset, so extracting all the components costs O(n+m) in total.
  */
 class BiconnectedComponentsHandler {
 private:
@@ -21,14 +24,19 @@ private:
     std::vector<bool> isCutVertex_m{};
     std::vector<int> cutVertices_m{};
     std::vector<std::unique_ptr<const SubGraph>> components_m{};
-    void dfsBicCom(const Node* node, int nodeId[], const Node* prevOfNode[], int& nextIdToAssign, int lowPoint[],
-        std::list<const Node*>& nodes, std::list<std::pair<const Node*, const Node*>>& edges);
-    SubGraph* buildComponent(std::list<const Node*>& nodes, std::list<std::pair<const Node*, const Node*>>& edges);
+    std::vector<int> oldToNewNodes_m{};
+    std::vector<std::pair<int, int>> componentEdges_m{};
+    void dfsBicCom(const int root, std::vector<int>& nodeId, std::vector<int>& prevOfNode, int& nextIdToAssign,
+        std::vector<int>& lowPoint, std::vector<int>& stackOfNodes, std::vector<std::pair<int, int>>& stackOfEdges);
+    SubGraph* buildComponent(const std::vector<int>& stackOfNodes, const int firstNode,
+        const std::vector<std::pair<int, int>>& stackOfEdges, const int firstEdge);
 public:
     BiconnectedComponentsHandler(const Graph* graph);
     void print() const;
     int size() const;
     const SubGraph* getComponent(const int index) const;
+    bool isCutVertex(const int nodeIndex) const;
+    const std::vector<int>& getCutVertices() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "blockCutTree.hpp"
+
+#include <cassert>
+
+/**
+ * @brief Constructs the block-cut tree of the given graph.
+ *
+ * The biconnected components are computed once, then the blocks containing each
+ * node and the parent links of the tree are computed, all in O(n+m).
+ *
+ * @param graph A pointer to the graph, which must outlive the tree.
+ */
+BlockCutTree::BlockCutTree(const Graph* graph) : graph_m(graph), blocks_m(graph) {
+    computeBlocksOfNodes();
+    computeParents();
+}
+
+/**
+ * @brief Computes, for each node of the graph, the indices of the blocks containing it.
+ *
+ * The result is stored in compressed form: the blocks of node i are
+ * blocksOfNodes_m[blocksOfNodesOffsets_m[i]] ... blocksOfNodes_m[blocksOfNodesOffsets_m[i+1]-1],
+ * in increasing order.
+ */
+void BlockCutTree::computeBlocksOfNodes() {
+    blocksOfNodesOffsets_m.assign(graph_m->size()+1, 0);
+    for (int i = 0; i < blocks_m.size(); ++i) {
+        const SubGraph* block = blocks_m.getComponent(i);
+        for (const Node* node : block->getNodes())
+            ++blocksOfNodesOffsets_m[block->getOriginalNode(node)->getIndex()+1];
+    }
+    for (int i = 0; i < graph_m->size(); ++i)
+        blocksOfNodesOffsets_m[i+1] += blocksOfNodesOffsets_m[i];
+    blocksOfNodes_m.resize(blocksOfNodesOffsets_m[graph_m->size()]);
+    std::vector<int> nextPosition(blocksOfNodesOffsets_m.begin(), blocksOfNodesOffsets_m.end()-1);
+    for (int i = 0; i < blocks_m.size(); ++i) {
+        const SubGraph* block = blocks_m.getComponent(i);
+        for (const Node* node : block->getNodes()) {
+            const int nodeIndex = block->getOriginalNode(node)->getIndex();
+            blocksOfNodes_m[nextPosition[nodeIndex]] = i;
+            ++nextPosition[nodeIndex];
+        }
+    }
+}
+
+/**
+ * @brief Computes the parent links of the tree with a breadth-first visit of each connected component.
+ *
+ * Each visit starts from the unvisited block with the lowest index, which becomes the
+ * root of the tree of its connected component.
+ */
+void BlockCutTree::computeParents() {
+    parentOfBlock_m.assign(blocks_m.size(), -1);
+    parentOfCutVertex_m.assign(graph_m->size(), -1);
+    std::vector<bool> isBlockVisited(blocks_m.size(), false);
+    std::vector<int> queue{};
+    queue.reserve(blocks_m.size());
+    for (int root = 0; root < blocks_m.size(); ++root) {
+        if (isBlockVisited[root]) continue;
+        ++numberOfTrees_m;
+        isBlockVisited[root] = true;
+        queue.clear();
+        queue.push_back(root);
+        for (int queuePosition = 0; queuePosition < queue.size(); ++queuePosition) {
+            const int blockIndex = queue[queuePosition];
+            const SubGraph* block = blocks_m.getComponent(blockIndex);
+            for (const Node* node : block->getNodes()) {
+                const int nodeIndex = block->getOriginalNode(node)->getIndex();
+                if (!blocks_m.isCutVertex(nodeIndex) || parentOfCutVertex_m[nodeIndex] != -1)
+                    continue;
+                parentOfCutVertex_m[nodeIndex] = blockIndex;
+                for (int i = 0; i < getNumberOfBlocksOfNode(nodeIndex); ++i) {
+                    const int childIndex = getBlockOfNode(nodeIndex, i);
+                    if (isBlockVisited[childIndex]) continue;
+                    isBlockVisited[childIndex] = true;
+                    parentOfBlock_m[childIndex] = nodeIndex;
+                    queue.push_back(childIndex);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Returns the graph of the tree.
+ *
+ * @return const Graph* A pointer to the graph the tree has been built for.
+ */
+const Graph* BlockCutTree::getGraph() const {
+    return graph_m;
+}
+
+/**
+ * @brief Returns the number of blocks (biconnected components) of the graph.
+ *
+ * @return int The number of blocks.
+ */
+int BlockCutTree::numberOfBlocks() const {
+    return blocks_m.size();
+}
+
+/**
+ * @brief Retrieves a block by its index.
+ *
+ * @param blockIndex The index of the block, in 0 ... numberOfBlocks()-1.
+ * @return const SubGraph* A pointer to the block, as a subgraph of the graph of the tree.
+ */
+const SubGraph* BlockCutTree::getBlock(const int blockIndex) const {
+    return blocks_m.getComponent(blockIndex);
+}
+
+/**
+ * @brief Returns the cut vertices of the graph.
+ *
+ * @return const std::vector<int>& The indices of the cut vertices, in increasing order.
+ */
+const std::vector<int>& BlockCutTree::getCutVertices() const {
+    return blocks_m.getCutVertices();
+}
+
+/**
+ * @brief Checks if a node of the graph is a cut vertex.
+ *
+ * @param nodeIndex The index of the node.
+ * @return true if the node is a cut vertex, false otherwise.
+ */
+bool BlockCutTree::isCutVertex(const int nodeIndex) const {
+    return blocks_m.isCutVertex(nodeIndex);
+}
+
+/**
+ * @brief Returns the number of blocks containing a node.
+ *
+ * @param nodeIndex The index of the node.
+ * @return int The number of blocks containing the node (more than one only for cut vertices).
+ */
+int BlockCutTree::getNumberOfBlocksOfNode(const int nodeIndex) const {
+    return blocksOfNodesOffsets_m[nodeIndex+1] - blocksOfNodesOffsets_m[nodeIndex];
+}
+
+/**
+ * @brief Retrieves one of the blocks containing a node.
+ *
+ * @param nodeIndex The index of the node.
+ * @param position The position of the block among the blocks of the node, in
+ *        0 ... getNumberOfBlocksOfNode(nodeIndex)-1.
+ * @return int The index of the block.
+ */
+int BlockCutTree::getBlockOfNode(const int nodeIndex, const int position) const {
+    assert(position < getNumberOfBlocksOfNode(nodeIndex));
+    return blocksOfNodes_m[blocksOfNodesOffsets_m[nodeIndex] + position];
+}
+
+/**
+ * @brief Returns the parent of a block in the tree.
+ *
+ * @param blockIndex The index of the block.
+ * @return int The index of the parent cut vertex, or -1 if the block is the root of its tree.
+ */
+int BlockCutTree::getParentOfBlock(const int blockIndex) const {
+    return parentOfBlock_m[blockIndex];
+}
+
+/**
+ * @brief Returns the parent of a cut vertex in the tree.
+ *
+ * @param nodeIndex The index of the cut vertex.
+ * @return int The index of the parent block, or -1 if the node is not a cut vertex.
+ */
+int BlockCutTree::getParentOfCutVertex(const int nodeIndex) const {
+    return parentOfCutVertex_m[nodeIndex];
+}
+
+/**
+ * @brief Checks if the graph is connected.
+ *
+ * @return true if the graph has a single connected component (the block-cut forest is a tree).
+ */
+bool BlockCutTree::isConnected() const {
+    return numberOfTrees_m <= 1;
+}
+
+/**
+ * @brief Checks if the graph is biconnected.
+ *
+ * @return true if the graph has at most one block, false otherwise.
+ */
+bool BlockCutTree::isBiconnected() const {
+    return numberOfBlocks() <= 1;
+}
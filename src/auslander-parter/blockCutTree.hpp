@@ -0,0 +1,50 @@
+#ifndef MY_BLOCK_CUT_TREE_H
+#define MY_BLOCK_CUT_TREE_H
+
+#include <vector>
+
+#include "../basic/graph.hpp"
+#include "biconnectedComponent.hpp"
+
+/**
+ * @class BlockCutTree
+ * @brief The block-cut tree of a graph: its blocks, its cut vertices and how they are linked.
+ *
+ * The blocks are the biconnected components of the graph, computed once by a
+ * BiconnectedComponentsHandler owned by the tree. Each block is linked to the cut
+ * vertices it contains, and each cut vertex to the blocks containing it. Every
+ * connected component of the graph gives a tree, rooted at its block with the lowest
+ * index: the parent of a non-root block is a cut vertex and the parent of a cut vertex
+ * is a block. The blocks containing each node are stored in compressed form (offsets
+ * and block indices).
+ *
+ * The tree is meant to be built once per input and shared by all the code needing
+ * the blocks or the connectivity of the graph, instead of recomputing them.
+ */
+class BlockCutTree {
+private:
+    const Graph* graph_m;
+    BiconnectedComponentsHandler blocks_m;
+    std::vector<int> blocksOfNodesOffsets_m{};
+    std::vector<int> blocksOfNodes_m{};
+    std::vector<int> parentOfBlock_m{};
+    std::vector<int> parentOfCutVertex_m{};
+    int numberOfTrees_m = 0;
+    void computeBlocksOfNodes();
+    void computeParents();
+public:
+    BlockCutTree(const Graph* graph);
+    const Graph* getGraph() const;
+    int numberOfBlocks() const;
+    const SubGraph* getBlock(const int blockIndex) const;
+    const std::vector<int>& getCutVertices() const;
+    bool isCutVertex(const int nodeIndex) const;
+    int getNumberOfBlocksOfNode(const int nodeIndex) const;
+    int getBlockOfNode(const int nodeIndex, const int position) const;
+    int getParentOfBlock(const int blockIndex) const;
+    int getParentOfCutVertex(const int nodeIndex) const;
+    bool isConnected() const;
+    bool isBiconnected() const;
+};
+
+#endif
@@ -1,74 +1,124 @@
 #include "cycle.hpp"
 
+#include <algorithm>
 #include <cassert>
 
 /**
- * @brief Performs a depth-first search (DFS) to build a cycle starting from the given node.
+ * @brief Builds the cycle walking the component from the given node.
  *
- * This function recursively traverses the graph to build a cycle. It starts from the given node,
- * marks it as visited, and explores its neighbors. If a neighbor has not been visited, the function
- * continues the DFS from that neighbor. If a neighbor has been visited and is not the previous node,
- * it indicates the presence of a cycle, and the neighbor is added to the cycle.
+ * The walk always moves to the first neighbor that is not the node it comes from, until it
+ * reaches an already visited node, which closes the cycle. The walk is written directly in
+ * nodes_m, with the position of each visited node in posInCycle_m, then the leading nodes
+ * that are not in the cycle are removed in place. The loop keeps no recursion state, so the
+ * length of the cycle is not bounded by the stack size.
  *
- * @param node The current node being visited.
- * @param isNodeVisited An array indicating whether each node has been visited.
- * @param prev The previous node in the DFS traversal.
+ * @example If the walk is [1, 2, 3, 4, 5] and 5 leads back to 3, the cycle is [4, 5, 3].
+ *
+ * @note If the walk reaches a node with no other neighbor, no cycle is found and the cycle is empty.
+ *
+ * @param start The node the walk starts from.
  */
-void Cycle::dfsBuildCycle(const Node* node, bool isNodeVisited[], const Node* prev) {
-    nodes_m.push_back(node);
-    isNodeVisited[node->getIndex()] = true;
-    for (const Node* neighbor : node->getNeighbors()) {
-        if (neighbor == prev)
-            continue;
-        if (!isNodeVisited[neighbor->getIndex()]) {
-            dfsBuildCycle(neighbor, isNodeVisited, node);
-            break;
-        }
-        nodes_m.push_back(neighbor);
+void Cycle::buildCycle(const Node* start) {
+    const Node* prev = nullptr;
+    const Node* node = start;
+    const Node* closingNode = nullptr;
+    while (closingNode == nullptr) {
+        posInCycle_m[node->getIndex()] = nodes_m.size();
+        nodes_m.push_back(node);
+        const Node* next = nullptr;
+        for (const Node* neighbor : node->getNeighbors())
+            if (neighbor != prev) {
+                next = neighbor;
+                break;
+            }
+        if (next == nullptr) break;
+        if (posInCycle_m[next->getIndex()] != -1)
+            closingNode = next;
+        prev = node;
+        node = next;
+    }
+    const int firstPosition = closingNode == nullptr ? nodes_m.size() : posInCycle_m[closingNode->getIndex()];
+    for (int i = 0; i < firstPosition; ++i)
+        posInCycle_m[nodes_m[i]->getIndex()] = -1;
+    if (closingNode == nullptr) {
+        nodes_m.clear();
         return;
     }
+    // the closing node goes last
+    std::rotate(nodes_m.begin()+firstPosition, nodes_m.begin()+firstPosition+1, nodes_m.end());
+    nodes_m.erase(nodes_m.begin(), nodes_m.begin()+firstPosition);
+    for (int i = 0; i < nodes_m.size(); ++i)
+        posInCycle_m[nodes_m[i]->getIndex()] = i;
 }
 
 /**
- * @brief Cleans up the cycle by removing leading nodes of the list that do not
- * partecipate in the cycle. Assumes starting node of the cycle is contained twice.
- * 
- * @example If the original list is [1, 2, 3, 4, 5, 3], the cleaned-up list will be [3, 4, 5, 3].
- * 
- * @note This function assumes that the last node in the list is the end of the cycle.
+ * @brief Builds the longest cycle closed by a back edge of a DFS of the component.
+ *
+ * The DFS is iterative and records the depth of each node in the tree. Every edge not in
+ * the tree links a node to one of its ancestors, and closes a cycle with the path of the
+ * tree between them, as long as the difference of their depths plus one; the longest of
+ * these cycles is kept.
+ *
+ * @note If the component has no back edge (it is not biconnected), the cycle is empty.
+ *
+ * @param start The root of the DFS.
  */
-void Cycle::cleanupCycle() {
-    std::vector<const Node*> copy(nodes_m);
-    nodes_m.clear();
-    bool foundEnd{false};
-    for (int i = 0; i < copy.size(); ++i) {
-        if (foundEnd) nodes_m.push_back(copy[i]);
-        else if (copy[i] == copy.back()) foundEnd = true;
+void Cycle::buildLongestDfsCycle(const Node* start) {
+    const int size = originalComponent_m->size();
+    std::vector<int> parent(size, -1);
+    std::vector<int> depth(size, -1);
+    std::vector<int> nextNeighbor(size, 0);
+    std::vector<const Node*> stack{start};
+    depth[start->getIndex()] = 0;
+    const Node* lowest = nullptr;
+    const Node* highest = nullptr;
+    int longest = 0;
+    while (!stack.empty()) {
+        const Node* node = stack.back();
+        const int nodeIndex = node->getIndex();
+        const NeighborsRange neighbors = node->getNeighbors();
+        if (nextNeighbor[nodeIndex] == neighbors.size()) {
+            stack.pop_back();
+            continue;
+        }
+        const Node* neighbor = neighbors[nextNeighbor[nodeIndex]++];
+        const int neighborIndex = neighbor->getIndex();
+        if (depth[neighborIndex] == -1) {
+            depth[neighborIndex] = depth[nodeIndex]+1;
+            parent[neighborIndex] = nodeIndex;
+            stack.push_back(neighbor);
+            continue;
+        }
+        // back edges towards an ancestor, the tree edge towards the parent is skipped
+        const int length = depth[nodeIndex]-depth[neighborIndex]+1;
+        if (neighborIndex != parent[nodeIndex] && length > longest) {
+            longest = length;
+            lowest = node;
+            highest = neighbor;
+        }
     }
+    if (lowest == nullptr) return;
+    for (int nodeIndex = lowest->getIndex(); nodeIndex != highest->getIndex(); nodeIndex = parent[nodeIndex]) {
+        posInCycle_m[nodeIndex] = nodes_m.size();
+        nodes_m.push_back(originalComponent_m->getNode(nodeIndex));
+    }
+    posInCycle_m[highest->getIndex()] = nodes_m.size();
+    nodes_m.push_back(highest);
 }
 
-
 /**
  * @brief Constructs a Cycle object from a given SubGraph component. Assumes subgraph
  * is a biconnected component.
  *
  * @param component A pointer to the SubGraph component from which the cycle is constructed.
+ * @param selection How the cycle is chosen among the cycles of the component.
  */
-Cycle::Cycle(const SubGraph* component) : originalComponent_m(component) {
-    int size = component->size();
-    bool isNodeVisited[size];
-    for (int node = 0; node < size; ++node)
-        isNodeVisited[node] = false;
-    dfsBuildCycle(component->getNode(0), isNodeVisited, nullptr);
-    cleanupCycle();
-    posInCycle_m.resize(size);
-    for (int i = 0; i < size; ++i)
-        posInCycle_m[i] = -1;
-    int index = 0;
-    for (const Node* node : nodes_m) {
-        posInCycle_m[node->getIndex()] = index;
-        ++index;
-    }
+Cycle::Cycle(const SubGraph* component, const CycleSelection selection) : originalComponent_m(component) {
+    posInCycle_m.assign(component->size(), -1);
+    if (selection == LONGEST_DFS_CYCLE)
+        buildLongestDfsCycle(component->getNode(0));
+    else
+        buildCycle(component->getNode(0));
 }
 
 /**
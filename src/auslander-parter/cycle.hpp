@@ -7,6 +7,22 @@
 
 #include "../basic/graph.hpp"
 
+/**
+ * @enum CycleSelection
+ * @brief How the first cycle of a biconnected component is chosen.
+ *
+ * FIRST_FOUND_CYCLE walks the component from its first node until the walk closes,
+ * which is cheap but may give a short cycle leaving a segment almost as large as the
+ * component. LONGEST_DFS_CYCLE takes the longest cycle made of a back edge and the path
+ * of the DFS tree it spans: the nodes outside the cycle, which the segments are made of,
+ * are as few as possible among those cycles, so the segments tend to be smaller and the
+ * recursion of the embedder shallower.
+ */
+enum CycleSelection : uint8_t {
+    FIRST_FOUND_CYCLE,
+    LONGEST_DFS_CYCLE,
+};
+
 /**
  * @class Cycle
  * @brief Represents a cycle within a subgraph.
@@ -15,8 +31,8 @@
  * methods to manipulate and query the cycle.
  *
  * @details This class maintains a list of nodes that form the cycle and their
- * positions within the cycle. It provides methods to build the cycle using
- * depth-first search, modify the cycle by including a path, and query various
+ * positions within the cycle. It provides methods to build the cycle with an
+ * iterative walk, modify the cycle by including a path, and query various
  * properties of the cycle.
  */
 class Cycle {
@@ -24,11 +40,11 @@ private:
     std::vector<const Node*> nodes_m{};
     std::vector<int> posInCycle_m{};
     const SubGraph* originalComponent_m;
-    void dfsBuildCycle(const Node* node, bool isNodeVisited[], const Node* prev);
-    void cleanupCycle();
+    void buildCycle(const Node* start);
+    void buildLongestDfsCycle(const Node* start);
     void nextIndex(int& index);
 public:
-    Cycle(const SubGraph* component);
+    Cycle(const SubGraph* component, const CycleSelection selection = FIRST_FOUND_CYCLE);
     void changeWithPath(std::list<const Node*>& path, const Node* nodeToInclude);
     bool hasNode(const Node* node) const;
     int size() const;
@@ -1,10 +1,18 @@
 #include "embedder.hpp"
 #include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <system_error>
+#include <thread>
+#include <tuple>
 
 #include <iostream>
 #include <sstream>
 
 #include "interlacement.hpp"
+#include "kuratowski.hpp"
+#include "leftRightPlanarity.hpp"
 #include "../basic/utils.hpp"
 
 /**
@@ -16,9 +24,10 @@
  *
  * @param originalGraph A pointer to the original Graph object from which
  *                      the Embedding is created.
+ * @param resource The memory resource the embedding is allocated from.
  */
-Embedding::Embedding(const SubGraph* originalGraph)
-: SubGraph(originalGraph->size(), originalGraph) {
+Embedding::Embedding(const SubGraph* originalGraph, std::pmr::memory_resource* resource)
+: SubGraph(originalGraph->size(), originalGraph, resource) {
     for (int i = 0; i < size(); ++i) {
         const Node* node = originalGraph->getNode(i);
         const Node* originalNode = originalGraph->getOriginalNode(node);
@@ -36,9 +45,10 @@ Embedding::Embedding(const SubGraph* originalGraph)
  *
  * @param originalGraph A pointer to the original SubGraph from which the 
  *                      Embedding is to be created.
+ * @param resource The memory resource the embedding is allocated from.
  */
-Embedding::Embedding(const Graph* originalGraph)
-: SubGraph(originalGraph->size(), originalGraph) {
+Embedding::Embedding(const Graph* originalGraph, std::pmr::memory_resource* resource)
+: SubGraph(originalGraph->size(), originalGraph, resource) {
     for (int i = 0; i < size(); ++i)
         setOriginalNode(getNode(i), originalGraph->getNode(i));
 }
@@ -91,31 +101,119 @@ std::string Embedding::toString() const {
     return ss.str();
 }
 
+/**
+ * @brief Adds the counters of another part of the recursion to these counters.
+ *
+ * @param other The counters to add, e.g. those of the blocks embedded by another thread.
+ */
+void RecursionCounters::add(const RecursionCounters& other) {
+    maxDepth_m = std::max(maxDepth_m, other.maxDepth_m);
+    numberOfCycleRepairs_m += other.numberOfCycleRepairs_m;
+}
+
+/**
+ * @brief Records that the recursion reached the given depth.
+ *
+ * @param depth The depth of the current call, 1 for the blocks of the graph.
+ */
+void RecursionCounters::recordDepth(const int depth) {
+    maxDepth_m = std::max(maxDepth_m, depth);
+}
+
+/**
+ * @brief Records that a cycle inducing a single segment has been repaired.
+ */
+void RecursionCounters::recordCycleRepair() {
+    ++numberOfCycleRepairs_m;
+}
+
+/**
+ * @brief Retrieves the deepest level reached by the recursion.
+ *
+ * @return The maximum depth, 0 if no component has been embedded.
+ */
+int RecursionCounters::getMaxDepth() const {
+    return maxDepth_m;
+}
+
+/**
+ * @brief Retrieves the number of cycles repaired because they induced a single segment.
+ *
+ * @return The number of repaired cycles.
+ */
+int RecursionCounters::getNumberOfCycleRepairs() const {
+    return numberOfCycleRepairs_m;
+}
+
+/**
+ * @brief Constructs an embedder.
+ *
+ * @param numberOfThreads The maximum number of threads used to embed the blocks of a
+ *        graph; with 1 (the default) the blocks are embedded one after another.
+ * @param cycleSelection How the first cycle of each component and segment is chosen.
+ * @param algorithm The planarity algorithm; numberOfThreads and cycleSelection only
+ *        apply to AUSLANDER_PARTER.
+ */
+Embedder::Embedder(const int numberOfThreads, const CycleSelection cycleSelection, const PlanarityAlgorithm algorithm)
+: numberOfThreads_m(numberOfThreads), cycleSelection_m(cycleSelection), algorithm_m(algorithm) {}
+
 /**
  * @brief Merges embeddings of biconnected components of a graph into a single embedding.
  *
- * This function takes a graph, its biconnected components, and their corresponding embeddings,
- * and merges them into a single embedding.
+ * The merge is driven by the block-cut tree. A node that is not a cut vertex takes its
+ * rotation from the only block containing it. The rotation of a cut vertex is the
+ * concatenation of its rotations in the blocks containing it: first its parent block,
+ * then its child blocks, each of them hanging from the cut vertex only. Every block
+ * thus stays in a single face of the others, and the result is planar.
+ *
+ * The position of each node in the embeddings of its blocks is found with a single
+ * pass over the embeddings, in the order of the per-node block lists, in O(n+m).
  *
  * @param graph The original graph.
- * @param biconnectedComponents Handler for the biconnected components of the graph.
- * @param embeddings A vector of unique pointers to the embeddings of the biconnected components.
+ * @param blockCutTree The block-cut tree of the graph.
+ * @param embeddings A vector of unique pointers to the embeddings of the blocks, in the order of the tree.
  * @return A pointer to the merged embedding.
  */
-const Embedding* Embedder::mergeBiconnectedComponents(const Graph* graph, const BiconnectedComponentsHandler& biconnectedComponents,
+const Embedding* Embedder::mergeBiconnectedComponents(const Graph* graph, const BlockCutTree& blockCutTree,
 const std::vector<std::unique_ptr<const Embedding>>& embeddings) const {
-    Embedding* output = new Embedding(graph);
-    assert(biconnectedComponents.size() == embeddings.size());
-    for (int i = 0; i < biconnectedComponents.size(); ++i) {
-        const SubGraph* component = biconnectedComponents.getComponent(i);
+    assert(blockCutTree.numberOfBlocks() == embeddings.size());
+    // the position of node i in the embedding of its p-th block is positionInBlock[firstSlot[i] + p]
+    std::vector<int> firstSlot(graph->size()+1, 0);
+    for (int i = 0; i < graph->size(); ++i)
+        firstSlot[i+1] = firstSlot[i] + blockCutTree.getNumberOfBlocksOfNode(i);
+    std::vector<int> positionInBlock(firstSlot[graph->size()]);
+    std::vector<int> nextSlot(firstSlot.begin(), firstSlot.end()-1);
+    for (int i = 0; i < blockCutTree.numberOfBlocks(); ++i) {
         const Embedding* embedding = embeddings[i].get();
-        for (int i = 0; i < embedding->size(); ++i) {
-            const Node* node = embedding->getNode(i);
-            const Node* nodeOriginal = embedding->getOriginalNode(node);
-            for (const Node* neighbor : node->getNeighbors()) {
-                const Node* neighborOriginal = embedding->getOriginalNode(neighbor);
-                output->addSingleEdge(nodeOriginal->getIndex(), neighborOriginal->getIndex());
-            }
+        for (int j = 0; j < embedding->size(); ++j) {
+            const int nodeIndex = embedding->getOriginalNode(embedding->getNode(j))->getIndex();
+            assert(blockCutTree.getBlockOfNode(nodeIndex, nextSlot[nodeIndex] - firstSlot[nodeIndex]) == i);
+            positionInBlock[nextSlot[nodeIndex]++] = j;
+        }
+    }
+    Embedding* output = new Embedding(graph);
+    auto addEdgesOfBlock = [&](const int nodeIndex, const int position) {
+        const Embedding* embedding = embeddings[blockCutTree.getBlockOfNode(nodeIndex, position)].get();
+        const Node* node = embedding->getNode(positionInBlock[firstSlot[nodeIndex] + position]);
+        for (const Node* neighbor : node->getNeighbors())
+            output->addSingleEdge(nodeIndex, embedding->getOriginalNode(neighbor)->getIndex());
+    };
+    for (int i = 0; i < graph->size(); ++i) {
+        const int numberOfBlocksOfNode = blockCutTree.getNumberOfBlocksOfNode(i);
+        if (!blockCutTree.isCutVertex(i)) {
+            assert(numberOfBlocksOfNode <= 1);
+            if (numberOfBlocksOfNode == 1) addEdgesOfBlock(i, 0);
+            continue;
+        }
+        const int parentBlock = blockCutTree.getParentOfCutVertex(i);
+        for (int position = 0; position < numberOfBlocksOfNode; ++position)
+            if (blockCutTree.getBlockOfNode(i, position) == parentBlock)
+                addEdgesOfBlock(i, position);
+        for (int position = 0; position < numberOfBlocksOfNode; ++position) {
+            const int blockIndex = blockCutTree.getBlockOfNode(i, position);
+            if (blockIndex == parentBlock) continue;
+            assert(blockCutTree.getParentOfBlock(blockIndex) == i);
+            addEdgesOfBlock(i, position);
         }
     }
     return output;
@@ -128,25 +226,188 @@ const std::vector<std::unique_ptr<const Embedding>>& embeddings) const {
  * returns an empty optional. Otherwise, it returns the final embedding.
  *
  * @param graph A pointer to the graph to be embedded.
+ * @param witness If not null and the graph is not planar, filled with the edges of a
+ *        subdivision of K5 or K3,3 contained in the graph, which proves that it is not
+ *        planar, as pairs of node indices (the lower index first), sorted.
+ * @param counters If not null, filled with the counters of the recursion of this call.
+ * @return An optional containing a pointer to the embedding if successful, or an empty optional if embedding is not possible.
+ */
+std::optional<const Embedding*> Embedder::embedGraph(const Graph* graph, std::vector<std::pair<int, int>>* witness,
+RecursionCounters* counters) const {
+    if (counters != nullptr) *counters = RecursionCounters{};
+    if (graph->size() < 4) return baseCaseGraph(graph);
+    if (graph->numberOfEdges() > (3*graph->size()-6) && witness == nullptr)
+        return std::nullopt;
+    if (algorithm_m == LEFT_RIGHT)
+        return embedGraphLeftRight(graph, witness);
+    const BlockCutTree blockCutTree(graph);
+    return embedGraph(graph, blockCutTree, witness, counters);
+}
+
+/**
+ * @brief Attempts to embed a given graph, reusing its already computed block-cut tree.
+ *
+ * Each block of the tree is embedded on its own, then the embeddings of the blocks
+ * are merged into the embedding of the graph.
+ *
+ * @param graph A pointer to the graph to be embedded.
+ * @param blockCutTree The block-cut tree of the graph.
+ * @param witness If not null and the graph is not planar, filled with a Kuratowski witness,
+ *        as in embedGraph(const Graph*, std::vector<std::pair<int, int>>*, RecursionCounters*).
+ * @param counters If not null, filled with the counters of the recursion of this call.
  * @return An optional containing a pointer to the embedding if successful, or an empty optional if embedding is not possible.
  */
-std::optional<const Embedding*> Embedder::embedGraph(const Graph* graph) const {
+std::optional<const Embedding*> Embedder::embedGraph(const Graph* graph, const BlockCutTree& blockCutTree,
+std::vector<std::pair<int, int>>* witness, RecursionCounters* counters) const {
+    assert(blockCutTree.getGraph() == graph);
+    if (counters != nullptr) *counters = RecursionCounters{};
     if (graph->size() < 4) return baseCaseGraph(graph);
-    if (graph->numberOfEdges() > (3*graph->size()-6))
+    if (graph->numberOfEdges() > (3*graph->size()-6) && witness == nullptr)
         return std::nullopt;
-    const BiconnectedComponentsHandler bicComps(graph);
+    if (algorithm_m == LEFT_RIGHT) // the block-cut tree is not needed
+        return embedGraphLeftRight(graph, witness);
+    RecursionCounters callCounters{};
+    std::optional<const Embedding*> embedding = embedBlocks(graph, blockCutTree, witness, callCounters);
+    if (counters != nullptr) *counters = callCounters;
+    return embedding;
+}
+
+/**
+ * @brief Embeds a graph with the left-right planarity test.
+ *
+ * If the graph is not planar and a witness is asked for, the test gives back the edges it
+ * met before failing, which already form a non-planar subgraph; only these are handed to
+ * a KuratowskiFinder, so there is no separate pass over the whole graph.
+ *
+ * @param graph A pointer to the graph to be embedded.
+ * @param witness If not null and the graph is not planar, filled with a Kuratowski witness.
+ * @return An optional containing a pointer to the embedding if successful, or an empty optional if embedding is not possible.
+ */
+std::optional<const Embedding*> Embedder::embedGraphLeftRight(const Graph* graph,
+std::vector<std::pair<int, int>>* witness) const {
+    LeftRightPlanarity leftRight(graph);
+    if (witness == nullptr)
+        return leftRight.computeEmbedding();
+    std::vector<std::pair<int, int>> nonPlanarEdges{};
+    std::optional<const Embedding*> embedding = leftRight.computeEmbedding(&nonPlanarEdges);
+    if (!embedding.has_value()) {
+        KuratowskiFinder finder(nonPlanarEdges);
+        *witness = finder.computeSubdivision();
+    }
+    return embedding;
+}
+
+/**
+ * @brief Embeds the blocks of a graph with the Auslander-Parter algorithm, then merges
+ * their embeddings.
+ *
+ * If a witness is asked for, the graph is not rejected by its number of edges, so that
+ * the recursion reaches a failure to extract the witness from.
+ *
+ * @param graph A pointer to the graph to be embedded.
+ * @param blockCutTree The block-cut tree of the graph.
+ * @param witness If not null and the graph is not planar, filled with a Kuratowski witness.
+ * @param counters The counters the recursion on the blocks is recorded in.
+ * @return An optional containing a pointer to the embedding if successful, or an empty optional if embedding is not possible.
+ */
+std::optional<const Embedding*> Embedder::embedBlocks(const Graph* graph, const BlockCutTree& blockCutTree,
+std::vector<std::pair<int, int>>* witness, RecursionCounters& counters) const {
+    if (numberOfThreads_m > 1 && blockCutTree.numberOfBlocks() > 1) {
+        std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource>> arenas{};
+        std::vector<std::unique_ptr<const Embedding>> embeddings(blockCutTree.numberOfBlocks());
+        if (!embedBlocksInParallel(blockCutTree, embeddings, arenas, witness, counters))
+            return std::nullopt;
+        return mergeBiconnectedComponents(graph, blockCutTree, embeddings);
+    }
+    std::pmr::monotonic_buffer_resource arena;
     std::vector<std::unique_ptr<const Embedding>> embeddings{};
-    for (int i = 0; i < bicComps.size(); ++i) {
-        const SubGraph* component = bicComps.getComponent(i);
-        std::optional<const Embedding*> embedding = embedComponent(component);
+    for (int i = 0; i < blockCutTree.numberOfBlocks(); ++i) {
+        const SubGraph* component = blockCutTree.getBlock(i);
+        std::optional<const Embedding*> embedding = embedComponent(component, &arena, 1, witness, counters);
         if (!embedding.has_value())
             return std::nullopt;
         embeddings.push_back(std::unique_ptr<const Embedding>(embedding.value()));
     }
-    const Embedding* embedding = mergeBiconnectedComponents(graph, bicComps, embeddings);
+    const Embedding* embedding = mergeBiconnectedComponents(graph, blockCutTree, embeddings);
     return embedding;
 }
 
+/**
+ * @brief Embeds the blocks of a graph on up to numberOfThreads_m threads.
+ *
+ * The blocks are handed out from a shared queue, sorted by decreasing number of edges,
+ * so the largest blocks start first and the small ones fill the remaining time. Each
+ * thread allocates from its own arena, since the arenas are not thread safe. As soon as
+ * a block is found non-planar, the blocks not started yet are skipped (the ones being
+ * embedded run to completion). If threads are not available (e.g. a build without
+ * thread support), the blocks are embedded by the calling thread.
+ *
+ * @param blockCutTree The block-cut tree of the graph.
+ * @param embeddings Output vector, with one entry per block, filled with the embeddings of the blocks.
+ * @param arenas Output vector of the arenas the embeddings are allocated from, which must
+ *        outlive the embeddings.
+ * @param witness If not null and a block is not planar, filled with a Kuratowski witness;
+ *        each worker extracts its own, and the one of the first worker that failed is kept.
+ * @param counters The counters the recursion on the blocks is recorded in; each worker
+ *        records in its own counters, added to these once all the workers are done.
+ * @return true if all the blocks are planar, false otherwise.
+ */
+bool Embedder::embedBlocksInParallel(const BlockCutTree& blockCutTree,
+std::vector<std::unique_ptr<const Embedding>>& embeddings,
+std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource>>& arenas,
+std::vector<std::pair<int, int>>* witness, RecursionCounters& counters) const {
+    const int numberOfBlocks = blockCutTree.numberOfBlocks();
+    assert(embeddings.size() == numberOfBlocks);
+    std::vector<int> order(numberOfBlocks);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&blockCutTree](int block1, int block2) {
+        return blockCutTree.getBlock(block1)->numberOfEdges() > blockCutTree.getBlock(block2)->numberOfEdges();
+    });
+    std::atomic<int> nextPosition{0};
+    std::atomic<bool> isNonPlanar{false};
+    const int numberOfWorkers = std::min(numberOfThreads_m, numberOfBlocks);
+    std::vector<std::vector<std::pair<int, int>>> witnesses(numberOfWorkers);
+    std::vector<RecursionCounters> workersCounters(numberOfWorkers);
+    auto embedBlocks = [&](int worker, std::pmr::memory_resource* arena) {
+        while (!isNonPlanar.load(std::memory_order_relaxed)) {
+            const int position = nextPosition.fetch_add(1);
+            if (position >= numberOfBlocks)
+                return;
+            const int blockIndex = order[position];
+            std::optional<const Embedding*> embedding = embedComponent(blockCutTree.getBlock(blockIndex), arena, 1,
+                witness != nullptr ? &witnesses[worker] : nullptr, workersCounters[worker]);
+            if (!embedding.has_value()) {
+                isNonPlanar.store(true, std::memory_order_relaxed);
+                return;
+            }
+            embeddings[blockIndex] = std::unique_ptr<const Embedding>(embedding.value());
+        }
+    };
+    for (int i = 0; i < numberOfWorkers; ++i)
+        arenas.push_back(std::make_unique<std::pmr::monotonic_buffer_resource>());
+    // the first worker runs on the calling thread
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numberOfWorkers; ++i) {
+        try {
+            threads.emplace_back(embedBlocks, i, arenas[i].get());
+        } catch (const std::system_error&) {
+            break;
+        }
+    }
+    embedBlocks(0, arenas[0].get());
+    for (std::thread& thread : threads)
+        thread.join();
+    for (const RecursionCounters& workerCounters : workersCounters)
+        counters.add(workerCounters);
+    if (witness != nullptr)
+        for (std::vector<std::pair<int, int>>& workerWitness : witnesses)
+            if (!workerWitness.empty()) {
+                *witness = std::move(workerWitness);
+                break;
+            }
+    return !isNonPlanar.load();
+}
+
 /**
  * @brief Computes the minimum and maximum attachment indices for each segment.
  *
@@ -162,10 +423,10 @@ std::optional<const Embedding*> Embedder::embedGraph(const Graph* graph) const {
 void Embedder::computeMinAndMaxSegmentsAttachments(const SegmentsHandler& segmentsHandler,
 int segmentsMinAttachment[], int segmentsMaxAttachment[]) const {
     for (int i = 0; i < segmentsHandler.size(); i++) {
-        int min = segmentsHandler.getSegment(i)->size();
-        int max = 0;
-        for (const Node* attachment : segmentsHandler.getSegment(i)->getAttachments()) {
-            int index = attachment->getIndex();
+        int min = segmentsHandler.getAttachmentPosition(i, 0);
+        int max = min;
+        for (int k = 1; k < segmentsHandler.getNumberOfAttachments(i); ++k) {
+            int index = segmentsHandler.getAttachmentPosition(i, k);
             if (index < min) min = index;
             if (index > max) max = index;
         }
@@ -181,8 +442,12 @@ int segmentsMinAttachment[], int segmentsMaxAttachment[]) const {
  * their minimum and maximum attachment points, and computes an ordered list of these segment
  * indexes, such that the segments are placed clockwise outside the cycle node 
  * without intersecting.
+ * The segments are split in one pass into the ones ending at the node, the ones starting
+ * at it and the (at most one) passing through it; the first two buckets are sorted with
+ * a strict comparator, so k segments take O(k log k) time. Segments on the same side do
+ * not interlace, so among the segments of a bucket with the same other extreme attachment
+ * all but at most one are paths, whatever their number of attachments.
  *
- * @param cycleNode Pointer to the cycle node.
  * @param segmentsIndexes Vector of segment indexes.
  * @param segmentsMinAttachment Array of minimum attachment points for each segment.
  * @param segmentsMaxAttachment Array of maximum attachment points for each segment.
@@ -190,12 +455,11 @@ int segmentsMinAttachment[], int segmentsMaxAttachment[]) const {
  * @param cycleNodePosition Position of the cycle node.
  * @return A vector of segment indexes ordered based on their attachment points and number of attachments.
  */
-std::vector<int> Embedder::computeOrder(const Node* cycleNode, const std::vector<int>& segmentsIndexes,
+std::vector<int> Embedder::computeOrder(const std::vector<int>& segmentsIndexes,
 int segmentsMinAttachment[], int segmentsMaxAttachment[], const SegmentsHandler& segmentsHandler, int cycleNodePosition) const {
     std::optional<int> middleSegment;
     std::vector<int> minSegments{};
     std::vector<int> maxSegments{};
-    int cycleNodeIndex = cycleNode->getIndex();
     for (int i = 0; i < segmentsIndexes.size(); ++i) {
         int segIndex = segmentsIndexes[i];
         if (segmentsMinAttachment[segIndex] == cycleNodePosition) {
@@ -209,73 +473,30 @@ int segmentsMinAttachment[], int segmentsMaxAttachment[], const SegmentsHandler&
         assert(!middleSegment.has_value());
         middleSegment = segIndex;
     }
-    for (int i = 0; i < int(maxSegments.size())-1; ++i) {
-        int min = i;
-        int minSeg = maxSegments[i];
-        for (int j = i+1; j < maxSegments.size(); ++j) {
-            int candidate = maxSegments[j];
-            if (segmentsMinAttachment[candidate] < segmentsMinAttachment[minSeg])
-                continue;
-            if (segmentsMinAttachment[candidate] > segmentsMinAttachment[minSeg]) {
-                minSeg = maxSegments[candidate];
-                min = j;
-                continue;
-            }
-            int numAttachmentsMin = segmentsHandler.getSegment(minSeg)->getAttachments().size();
-            int numAttachmentsCandidate = segmentsHandler.getSegment(candidate)->getAttachments().size();
-            assert(numAttachmentsMin == 2 || numAttachmentsMin == 3);
-            assert(numAttachmentsCandidate == 2 || numAttachmentsCandidate == 3);
-            if (numAttachmentsMin == 2 && numAttachmentsCandidate == 2) {
-                if (minSeg > candidate)
-                    continue;
-                minSeg = candidate;
-                min = j;
-                continue;
-            }
-            if (numAttachmentsCandidate == 3) {
-                assert(numAttachmentsMin == 2);
-                minSeg = candidate;
-                min = j;
-            }
-        }
-        int temp = maxSegments[min];
-        maxSegments[min] = maxSegments[i];
-        maxSegments[i] = temp;
-    }
-    // ordering minSegments
-    for (int i = 0; i < int(minSegments.size())-1; ++i) {
-        int min = i;
-        int minSeg = minSegments[i];
-        for (int j = i+1; j < minSegments.size(); ++j) {
-            int candidate = minSegments[j];
-            if (segmentsMaxAttachment[candidate] < segmentsMaxAttachment[minSeg])
-                continue;
-            if (segmentsMaxAttachment[candidate] > segmentsMaxAttachment[minSeg]) {
-                min = j;
-                minSeg = minSegments[j];
-                continue;
-            }
-            int numAttachmentsMax = segmentsHandler.getSegment(minSeg)->getAttachments().size();
-            int numAttachmentsCandidate = segmentsHandler.getSegment(candidate)->getAttachments().size();
-            assert(numAttachmentsMax == 2 || numAttachmentsMax == 3);
-            assert(numAttachmentsCandidate == 2 || numAttachmentsCandidate == 3);
-            if (numAttachmentsMax == 2 && numAttachmentsCandidate == 2) {
-                if (minSeg < candidate)
-                    continue;
-                minSeg = candidate;
-                min = j;
-                continue;
-            }
-            if (numAttachmentsMax == 3) {
-                assert(numAttachmentsCandidate == 2);
-                minSeg = candidate;
-                min = j;
-            }
-        }
-        int temp = minSegments[min];
-        minSegments[min] = minSegments[i];
-        minSegments[i] = temp;
-    }
+    // segments with the same min and max attachments on the same side are all paths,
+    // except at most one, which has attachments in between
+    auto hasMiddleAttachments = [&segmentsHandler](int segmentIndex) {
+        return segmentsHandler.getNumberOfAttachments(segmentIndex) > 2;
+    };
+    // segments ending at the node: by decreasing min attachment, then the one with
+    // attachments in between first, then by decreasing index
+    std::sort(maxSegments.begin(), maxSegments.end(), [&](int segment1, int segment2) {
+        return std::make_tuple(segmentsMinAttachment[segment1], hasMiddleAttachments(segment1), segment1) >
+            std::make_tuple(segmentsMinAttachment[segment2], hasMiddleAttachments(segment2), segment2);
+    });
+    // segments starting at the node: by decreasing max attachment, then the one with
+    // attachments in between last, then by increasing index
+    std::sort(minSegments.begin(), minSegments.end(), [&](int segment1, int segment2) {
+        return std::make_tuple(-segmentsMaxAttachment[segment1], hasMiddleAttachments(segment1), segment1) <
+            std::make_tuple(-segmentsMaxAttachment[segment2], hasMiddleAttachments(segment2), segment2);
+    });
+    // two such segments with attachments in between would interlace, so they cannot be on the same side
+    for (int i = 1; i < maxSegments.size(); ++i)
+        assert(segmentsMinAttachment[maxSegments[i-1]] != segmentsMinAttachment[maxSegments[i]] ||
+            !hasMiddleAttachments(maxSegments[i-1]) || !hasMiddleAttachments(maxSegments[i]));
+    for (int i = 1; i < minSegments.size(); ++i)
+        assert(segmentsMaxAttachment[minSegments[i-1]] != segmentsMaxAttachment[minSegments[i]] ||
+            !hasMiddleAttachments(minSegments[i-1]) || !hasMiddleAttachments(minSegments[i]));
     std::vector<int> order{};
     for (int segmentIndex : maxSegments)
         order.push_back(segmentIndex);
@@ -291,6 +512,8 @@ int segmentsMinAttachment[], int segmentsMaxAttachment[], const SegmentsHandler&
  *
  * The embedding is "compatible" with the cycle if, drawn the cycle clockwise,
  * the embedding of the segment places the segment inside the cycle.
+ * Chords have no embedding, and a single edge at each endpoint, so they are
+ * considered compatible.
  * 
  * @param component A pointer to the SubGraph component.
  * @param cycle A pointer to the Cycle object.
@@ -302,6 +525,10 @@ std::vector<bool> Embedder::compatibilityEmbeddingsAndCycle(const SubGraph* comp
 const std::vector<std::unique_ptr<const Embedding>>& embeddings, const SegmentsHandler& segmentsHandler) const {
     std::vector<bool> isCompatible(segmentsHandler.size());
     for (int i = 0; i < segmentsHandler.size(); ++i) {
+        if (segmentsHandler.isChord(i)) {
+            isCompatible[i] = true;
+            continue;
+        }
         const Segment* segment = segmentsHandler.getSegment(i);
         const Embedding* embedding = embeddings[i].get();
         const Node* attachment = segment->getAttachments()[0]; // any attachment is good
@@ -310,7 +537,7 @@ const std::vector<std::unique_ptr<const Embedding>>& embeddings, const SegmentsH
         const Node* prev = cycle->getPrevOfNode(componentNode);
         int position = -1;
         int attachmentIndex = attachment->getIndex();
-        const std::vector<const Node*>& neighbors = embedding->getNode(attachmentIndex)->getNeighbors();
+        const NeighborsRange neighbors = embedding->getNode(attachmentIndex)->getNeighbors();
         assert(neighbors.size() >= 3);
         for (int j = 0; j < neighbors.size(); ++j) {
             const Node* neighbor = neighbors[j];
@@ -356,7 +583,7 @@ const SubGraph* component, bool compatible, Embedding* output) const {
     assert(nextCycleNode->getGraph() == component);
     assert(segment->isNodeAnAttachment(segment->getNode(cycleNodeIndex)));
     std::vector<int> neighborsToAdd;
-    const std::vector<const Node*>& neighbors = embedding->getNode(cycleNodeIndex)->getNeighbors();
+    const NeighborsRange neighbors = embedding->getNode(cycleNodeIndex)->getNeighbors();
     int positionOfLastAddedNode = -1;
     for (int i = 0; i < neighbors.size(); ++i) {
         const Node* neighbor = neighbors[i];
@@ -399,62 +626,91 @@ const SubGraph* component, bool compatible, Embedding* output) const {
         }
 }
 
+/**
+ * @brief Adds the edge of a chord at one of its endpoints to the final embedding.
+ *
+ * A chord has a single edge at each endpoint, so its place among the segments at
+ * the endpoint is all that matters, and no embedding of the chord is needed.
+ *
+ * @param chord The chord.
+ * @param cycle The cycle the chord belongs to.
+ * @param cycleNodePosition The position in the cycle of the endpoint to process.
+ * @param output Pointer to the Embedding object where the new edge will be added.
+ */
+void Embedder::addChordEdge(const Chord& chord, const Cycle* cycle, int cycleNodePosition, Embedding* output) const {
+    assert(chord.from == cycleNodePosition || chord.to == cycleNodePosition);
+    const int otherPosition = chord.from == cycleNodePosition ? chord.to : chord.from;
+    output->addSingleEdge(cycle->getNode(cycleNodePosition)->getIndex(), cycle->getNode(otherPosition)->getIndex());
+}
+
 /**
  * @brief Merges segment embeddings into a single embedding for a given biconnected
  * component and cycle.
  *
+ * The segments at each cycle node are taken from the attachments index of the handler,
+ * so the segments are gathered in time linear in the total number of attachments.
+ *
  * @param component The subgraph biconnected component for which the embedding is being created.
  * @param cycle The cycle within the subgraph component.
- * @param embeddings A vector of unique pointers to the embeddings of the segments.
+ * @param embeddings A vector of unique pointers to the embeddings of the segments (null for chords).
  * @param segmentsHandler Handler for managing segments within the subgraph.
  * @param bipartition A vector representing the bipartition of the segments inside
  *                      and outside the cycle.
+ * @param resource The memory resource the embedding is allocated from.
  * @return A pointer to the newly created Embedding object.
  */
 const Embedding* Embedder::mergeSegmentsEmbeddings(const SubGraph* component, const Cycle* cycle,
 const std::vector<std::unique_ptr<const Embedding>>& embeddings, const SegmentsHandler& segmentsHandler,
-const std::vector<int>& bipartition) const {
-    Embedding* output = new Embedding(component);
+const std::vector<int>& bipartition, std::pmr::memory_resource* resource) const {
+    Embedding* output = new Embedding(component, resource);
     int segmentsMinAttachment[segmentsHandler.size()];
     int segmentsMaxAttachment[segmentsHandler.size()];
     computeMinAndMaxSegmentsAttachments(segmentsHandler, segmentsMinAttachment, segmentsMaxAttachment);
     std::vector<bool> isSegmentCompatible = compatibilityEmbeddingsAndCycle(component, cycle, embeddings, segmentsHandler);
+    // the embeddings of the segments outside the cycle are mirrored, once for all their attachments
+    for (int i = 0; i < segmentsHandler.size(); ++i)
+        if (bipartition[i] == 1) isSegmentCompatible[i] = !isSegmentCompatible[i];
     for (int cycleNodePosition = 0; cycleNodePosition < cycle->size(); ++cycleNodePosition) {
         std::vector<int> insideSegments{};
         std::vector<int> outsideSegments{};
-        for (int i = 0; i < segmentsHandler.size(); ++i) {
-            const Node* node = segmentsHandler.getSegment(i)->getNode(cycleNodePosition);
-            if (segmentsHandler.getSegment(i)->isNodeAnAttachment(node)) {
-                if (bipartition[i] == 0) insideSegments.push_back(i);
-                else outsideSegments.push_back(i);
-            }
+        for (int k = 0; k < segmentsHandler.getNumberOfSegmentsAttachedAt(cycleNodePosition); ++k) {
+            const int i = segmentsHandler.getSegmentAttachedAt(cycleNodePosition, k);
+            if (bipartition[i] == 0) insideSegments.push_back(i);
+            else outsideSegments.push_back(i);
         }
         const Node* cycleNode = cycle->getNode(cycleNodePosition);
         const Node* prevCycleNode = cycle->getPrevOfNode(cycleNode);
         const Node* nextCycleNode = cycle->getNextOfNode(cycleNode);
         // order of the segments inside the cycle
-        std::vector<int> insideOrder = computeOrder(cycleNode, insideSegments,
+        std::vector<int> insideOrder = computeOrder(insideSegments,
             segmentsMinAttachment, segmentsMaxAttachment, segmentsHandler, cycleNodePosition);
         reverseVector(insideOrder);
         // order of the segments outside the cycle
-        std::vector<int> outsideOrder = computeOrder(cycleNode, outsideSegments,
+        std::vector<int> outsideOrder = computeOrder(outsideSegments,
             segmentsMinAttachment, segmentsMaxAttachment, segmentsHandler, cycleNodePosition);
-        for (int index : outsideOrder)
-            isSegmentCompatible[index] = !isSegmentCompatible[index];
         output->addSingleEdge(cycleNode->getIndex(), nextCycleNode->getIndex());
         for (int i = 0; i < insideOrder.size(); ++i) {
+            if (segmentsHandler.isChord(insideOrder[i])) {
+                addChordEdge(segmentsHandler.getChord(insideOrder[i]), cycle, cycleNodePosition, output);
+                continue;
+            }
             const Segment* segment = segmentsHandler.getSegment(insideOrder[i]);
             const Embedding* embedding = embeddings[insideOrder[i]].get();
             addMiddleEdges(segment, embedding, cycleNodePosition, component, isSegmentCompatible[insideOrder[i]], output);
         }
         output->addSingleEdge(cycleNode->getIndex(), prevCycleNode->getIndex());
         for (int i = 0; i < outsideOrder.size(); ++i) {
+            if (segmentsHandler.isChord(outsideOrder[i])) {
+                addChordEdge(segmentsHandler.getChord(outsideOrder[i]), cycle, cycleNodePosition, output);
+                continue;
+            }
             const Segment* segment = segmentsHandler.getSegment(outsideOrder[i]);
             const Embedding* embedding = embeddings[outsideOrder[i]].get();
             addMiddleEdges(segment, embedding, cycleNodePosition, component, isSegmentCompatible[outsideOrder[i]], output);
         }
     }
     for (int i = 0; i < segmentsHandler.size(); ++i) {
+        if (segmentsHandler.isChord(i)) continue; // chords have no nodes outside the cycle
         const Segment* segment = segmentsHandler.getSegment(i);
         const Embedding* embedding = embeddings[i].get();
         for (int nodeIndex = 0; nodeIndex < segment->size(); ++nodeIndex) {
@@ -489,33 +745,53 @@ const std::vector<int>& bipartition) const {
  *
  * @param component A pointer to the subgraph component to be embedded.
  * @param cycle A pointer to the cycle into which the component is to be embedded.
+ * @param resource The memory resource the embedding of the component is allocated from;
+ *        the segments and their embeddings are allocated from an arena of this call.
+ * @param depth The depth of the call in the recursion, 1 for the blocks of the graph.
+ * @param witness If not null and the component is not planar, filled with a Kuratowski witness.
+ * @param counters The counters the recursion is recorded in.
  * @return An optional containing a pointer to the resulting embedding if successful, 
  *         or std::nullopt if the embedding fails.
  */
-std::optional<const Embedding*> Embedder::embedComponent(const SubGraph* component, Cycle* cycle) const {
-    const SegmentsHandler segmentsHandler = SegmentsHandler(component, cycle);
-    if (segmentsHandler.size() == 0) // entire biconnected component is a cycle
-        return baseCaseCycle(component);
-    if (segmentsHandler.size() == 1) {
-        const Segment* segment = segmentsHandler.getSegment(0);
-        if (segment->isPath())
-            return baseCaseComponent(component, cycle);
-        // chosen cycle is bad
-        makeCycleGood(cycle, segment);
-        return embedComponent(component, cycle);
+std::optional<const Embedding*> Embedder::embedComponent(const SubGraph* component, Cycle* cycle,
+std::pmr::memory_resource* resource, const int depth, std::vector<std::pair<int, int>>* witness,
+RecursionCounters& counters) const {
+    counters.recordDepth(depth);
+    // the segments and their embeddings are only needed until they are merged
+    std::pmr::monotonic_buffer_resource arena;
+    SegmentsHandler segmentsHandler(component, cycle, &arena);
+    while (segmentsHandler.size() == 1 && !segmentsHandler.isChord(0) && !segmentsHandler.getSegment(0)->isPath()) {
+        // chosen cycle is bad, the segments are updated around the new path of the cycle
+        const std::list<const Node*> path = makeCycleGood(cycle, segmentsHandler.getSegment(0));
+        counters.recordCycleRepair();
+        segmentsHandler = SegmentsHandler(component, cycle, path, &arena);
     }
+    if (segmentsHandler.size() == 0) // entire biconnected component is a cycle
+        return baseCaseCycle(component, resource);
+    if (segmentsHandler.size() == 1) // the only segment is a path (or a chord)
+        return baseCaseComponent(component, cycle, resource);
     InterlacementGraph interlacementGraph(cycle, segmentsHandler);
-    std::optional<std::vector<int>> bipartition = interlacementGraph.computeBipartition();
-    if (!bipartition) return std::nullopt;
+    std::vector<int> oddCycle{};
+    std::optional<std::vector<int>> bipartition = interlacementGraph.computeBipartition(
+        witness != nullptr ? &oddCycle : nullptr);
+    if (!bipartition) {
+        if (witness != nullptr) *witness = computeWitness(component, cycle, segmentsHandler, oddCycle);
+        return std::nullopt;
+    }
     std::vector<std::unique_ptr<const Embedding>> embeddings{};
     for (int i = 0; i < segmentsHandler.size(); ++i) {
+        if (segmentsHandler.isChord(i)) { // nothing to embed
+            embeddings.push_back(nullptr);
+            continue;
+        }
         const Segment* segment = segmentsHandler.getSegment(i);
-        std::optional<const Embedding*> embedding = embedComponent(segment);
+        std::optional<const Embedding*> embedding = embedComponent(segment, &arena, depth+1, witness, counters);
         if (!embedding.has_value())
             return std::nullopt;
         embeddings.push_back(std::unique_ptr<const Embedding>(embedding.value()));
     }
-    const Embedding* embedding = mergeSegmentsEmbeddings(component, cycle, embeddings, segmentsHandler, bipartition.value());
+    const Embedding* embedding = mergeSegmentsEmbeddings(component, cycle, embeddings, segmentsHandler,
+        bipartition.value(), resource);
     return embedding;
 }
 
@@ -525,18 +801,65 @@ std::optional<const Embedding*> Embedder::embedComponent(const SubGraph* compone
  * This function attempts to embed the provided subgraph component into an embedding.
  * If the embedding is successful, it returns the embedding; otherwise,
  * it returns an empty optional.
+ * Blocks with fewer than three nodes have a single embedding, with no cycle to split on.
  *
  * @param component A pointer to the subgraph component to be embedded.
+ * @param resource The memory resource segments and embeddings are allocated from.
+ * @param depth The depth of the call in the recursion, 1 for the blocks of the graph.
+ * @param witness If not null and the component is not planar, filled with a Kuratowski witness.
+ * @param counters The counters the recursion is recorded in.
  * @return std::optional<const Embedding*> An optional containing the embedding if successful,
  *         or std::nullopt if the embedding could not be created.
  */
-std::optional<const Embedding*> Embedder::embedComponent(const SubGraph* component) const {
-    Cycle cycle(component);
-    std::optional<const Embedding*> embedding = embedComponent(component, &cycle);
+std::optional<const Embedding*> Embedder::embedComponent(const SubGraph* component, std::pmr::memory_resource* resource,
+const int depth, std::vector<std::pair<int, int>>* witness, RecursionCounters& counters) const {
+    if (component->size() < 3) // a bridge or an isolated node, which has no cycle
+        return baseCaseCycle(component, resource);
+    Cycle cycle(component, cycleSelection_m);
+    std::optional<const Embedding*> embedding = embedComponent(component, &cycle, resource, depth, witness, counters);
     if (!embedding.has_value()) return std::nullopt;
     return embedding;
 }
 
+/**
+ * @brief Computes the Kuratowski witness of a component whose segments cannot be placed
+ * on the two sides of its cycle.
+ *
+ * The cycle and the segments of an odd cycle of conflicts are already not planar: any
+ * embedding of them would place each of these segments on the other side of the cycle
+ * with respect to the next one. Only that subgraph is handed to a KuratowskiFinder.
+ *
+ * @param component The component that cannot be embedded.
+ * @param cycle The cycle of the component.
+ * @param segmentsHandler The segments of the cycle.
+ * @param oddCycle The indices of the segments forming an odd cycle of conflicts.
+ * @return The edges of the witness, as pairs of node indices of the graph.
+ */
+std::vector<std::pair<int, int>> Embedder::computeWitness(const SubGraph* component, const Cycle* cycle, const SegmentsHandler& segmentsHandler,
+const std::vector<int>& oddCycle) const {
+    auto originalIndex = [component](const Node* node) {
+        return component->getOriginalNode(node)->getIndex();
+    };
+    std::vector<std::pair<int, int>> edges{};
+    for (int i = 0; i < cycle->size(); ++i)
+        edges.push_back({originalIndex(cycle->getNode(i)), originalIndex(cycle->getNode((i+1) % cycle->size()))});
+    for (const int index : oddCycle) {
+        if (segmentsHandler.isChord(index)) {
+            const Chord& chord = segmentsHandler.getChord(index);
+            edges.push_back({originalIndex(cycle->getNode(chord.from)), originalIndex(cycle->getNode(chord.to))});
+            continue;
+        }
+        const Segment* segment = segmentsHandler.getSegment(index);
+        for (const Node* node : segment->getNodes())
+            for (const Node* neighbor : node->getNeighbors())
+                if (node->getIndex() < neighbor->getIndex())
+                    edges.push_back({segment->getOriginalNode(node)->getIndex(),
+                        segment->getOriginalNode(neighbor)->getIndex()});
+    }
+    KuratowskiFinder finder(edges);
+    return finder.computeSubdivision();
+}
+
 /**
  * @brief Ensures that the given not "separating" cycle becomes "separating" by modifying
  * it based on the provided segment.
@@ -545,8 +868,9 @@ std::optional<const Embedding*> Embedder::embedComponent(const SubGraph* compone
  *
  * @param cycle A pointer to the Cycle object that needs to be modified.
  * @param segment A pointer to the Segment object that provides the nodes and attachments to be used.
+ * @return The path of the segment, as component nodes, now in the cycle.
  */
-void Embedder::makeCycleGood(Cycle* cycle, const Segment* segment) const {
+std::list<const Node*> Embedder::makeCycleGood(Cycle* cycle, const Segment* segment) const {
     assert(!segment->isPath());
     bool isCycleNodeAttachment[cycle->size()];
     for (int i = 0; i < cycle->size(); ++i)
@@ -576,6 +900,7 @@ void Embedder::makeCycleGood(Cycle* cycle, const Segment* segment) const {
     if (attachmentToInclude != nullptr)
         attachmentToInclude = segment->getComponentNode(attachmentToInclude);
     cycle->changeWithPath(pathComponent, attachmentToInclude);
+    return pathComponent;
 }
 
 /**
@@ -606,13 +931,15 @@ const Embedding* Embedder::baseCaseGraph(const Graph* graph) const {
  *
  * @param component A pointer to the subgraph component to be embedded.
  * @param cycle A pointer to the cycle used to determine the order of neighbors for nodes with three neighbors.
+ * @param resource The memory resource the embedding is allocated from.
  * @return A pointer to the constructed Embedding object.
  */
-const Embedding* Embedder::baseCaseComponent(const SubGraph* component, const Cycle* cycle) const {
-    Embedding* embedding = new Embedding(component);
+const Embedding* Embedder::baseCaseComponent(const SubGraph* component, const Cycle* cycle,
+std::pmr::memory_resource* resource) const {
+    Embedding* embedding = new Embedding(component, resource);
     for (int nodeIndex = 0; nodeIndex < component->size(); ++nodeIndex) {
         const Node* node = component->getNode(nodeIndex);
-        const std::vector<const Node*>& neighbors = node->getNeighbors();
+        const NeighborsRange neighbors = node->getNeighbors();
         if (neighbors.size() == 2) { // attachment nodes will be handled later
             embedding->addSingleEdge(node->getIndex(), neighbors[0]->getIndex());
             embedding->addSingleEdge(node->getIndex(), neighbors[1]->getIndex());
@@ -646,10 +973,11 @@ const Embedding* Embedder::baseCaseComponent(const SubGraph* component, const Cy
  * just a cycle.
  *
  * @param cycle A pointer to the SubGraph representing the cycle to be embedded.
+ * @param resource The memory resource the embedding is allocated from.
  * @return A pointer to the newly created Embedding object representing the cycle.
  */
-const Embedding* Embedder::baseCaseCycle(const SubGraph* cycle) const {
-    Embedding* embedding = new Embedding(cycle);
+const Embedding* Embedder::baseCaseCycle(const SubGraph* cycle, std::pmr::memory_resource* resource) const {
+    Embedding* embedding = new Embedding(cycle, resource);
     for (int i = 0; i < cycle->size()-1; ++i)
         for (const Node* neighbor : cycle->getNode(i)->getNeighbors())
             if (i < neighbor->getIndex())
@@ -1,12 +1,15 @@
 #ifndef MY_EMBEDDER_H
 #define MY_EMBEDDER_H
 
+#include <list>
 #include <optional>
+#include <utility>
 #include <vector>
 #include <string>
+#include <memory_resource>
 
 #include "../basic/graph.hpp"
-#include "biconnectedComponent.hpp"
+#include "blockCutTree.hpp"
 #include "cycle.hpp"
 #include "segment.hpp"
 
@@ -19,43 +22,114 @@
  */
 class Embedding : public SubGraph {
 public:
-    Embedding(const SubGraph* originalGraph);
-    Embedding(const Graph* originalGraph);
+    Embedding(const SubGraph* originalGraph, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    Embedding(const Graph* originalGraph, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     void addSingleEdge(int fromIndex, int toIndex);
     void addSingleEdge(Node* from, const Node* to);
     std::string toString() const;
 };
 
+/**
+ * @class RecursionCounters
+ * @brief Counters describing the recursion of an embedding computed by an embedder.
+ *
+ * The depth is the deepest nesting of the recursive calls on a component with a cycle,
+ * each segment being one level below its component. A repair (a cycle inducing a single
+ * segment that is not a path is changed with a path of the segment) does not add a level.
+ * Each call of embedGraph fills its own counters; the blocks embedded by different threads
+ * count in separate counters, added together at the end.
+ */
+class RecursionCounters {
+private:
+    int maxDepth_m = 0;
+    int numberOfCycleRepairs_m = 0;
+public:
+    void add(const RecursionCounters& other);
+    void recordDepth(const int depth);
+    void recordCycleRepair();
+    int getMaxDepth() const;
+    int getNumberOfCycleRepairs() const;
+};
+
+/**
+ * @enum PlanarityAlgorithm
+ * @brief The algorithm used by an Embedder to test and embed a graph.
+ *
+ * AUSLANDER_PARTER is the recursive Auslander-Parter algorithm, which splits each block
+ * into a cycle and its segments; it is superlinear in the worst case, but close to the
+ * textbook description, and serves as the reference. LEFT_RIGHT is the linear-time
+ * left-right planarity test (see LeftRightPlanarity), meant for large graphs. Both give
+ * an Embedding of the graph, though not necessarily the same one.
+ */
+enum PlanarityAlgorithm : uint8_t {
+    AUSLANDER_PARTER,
+    LEFT_RIGHT,
+};
+
 /**
  * @class Embedder
  * @brief Computes the embedding of a graph, if it is planar.
  * Visualizes the embedding in an SVG file.
  * 
  * It uses the Auslander-Parter algorithm to embed the graph.
+ * The segments of a component, and the embeddings of these segments, are allocated from
+ * a monotonic arena owned by the call embedding the component, released at once when
+ * their embeddings are merged; the embedding of each block is kept in an arena owned by
+ * embedGraph until the blocks are merged, and only the returned embedding uses the default heap.
+ * The blocks of the graph are independent, so they can be embedded in parallel by up
+ * to numberOfThreads threads, each with its own arena; see embedBlocksInParallel.
+ * The first cycle of each component is chosen as selected by cycleSelection, and the
+ * depth reached by the recursion is reported in the counters given to embedGraph, if any.
+ * With the LEFT_RIGHT algorithm, the whole graph is handed to LeftRightPlanarity instead,
+ * and the recursion counters stay at zero.
+ * A graph found not planar comes with a Kuratowski witness if embedGraph is given where to
+ * put it, extracted from the cycle and the odd cycle of interlaced segments on which the
+ * recursion failed; with LEFT_RIGHT, from the edges met by the test before it failed.
  */
 class Embedder {
 private:
-    void makeCycleGood(Cycle* cycle, const Segment* segment) const;
+    int numberOfThreads_m;
+    CycleSelection cycleSelection_m;
+    PlanarityAlgorithm algorithm_m;
+    std::optional<const Embedding*> embedGraphLeftRight(const Graph* graph, std::vector<std::pair<int, int>>* witness) const;
+    std::optional<const Embedding*> embedBlocks(const Graph* graph, const BlockCutTree& blockCutTree,
+        std::vector<std::pair<int, int>>* witness, RecursionCounters& counters) const;
+    bool embedBlocksInParallel(const BlockCutTree& blockCutTree,
+        std::vector<std::unique_ptr<const Embedding>>& embeddings,
+        std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource>>& arenas,
+        std::vector<std::pair<int, int>>* witness, RecursionCounters& counters) const;
+    std::list<const Node*> makeCycleGood(Cycle* cycle, const Segment* segment) const;
     const Embedding* baseCaseGraph(const Graph* graph) const;
-    const Embedding* baseCaseComponent(const SubGraph* segment, const Cycle* cycle) const;
-    const Embedding* baseCaseCycle(const SubGraph* cycle) const;
-    std::optional<const Embedding*> embedComponent(const SubGraph* component) const;
-    std::optional<const Embedding*> embedComponent(const SubGraph* component, Cycle* cycle) const;
+    const Embedding* baseCaseComponent(const SubGraph* segment, const Cycle* cycle, std::pmr::memory_resource* resource) const;
+    const Embedding* baseCaseCycle(const SubGraph* cycle, std::pmr::memory_resource* resource) const;
+    std::optional<const Embedding*> embedComponent(const SubGraph* component, std::pmr::memory_resource* resource,
+        const int depth, std::vector<std::pair<int, int>>* witness, RecursionCounters& counters) const;
+    std::optional<const Embedding*> embedComponent(const SubGraph* component, Cycle* cycle,
+        std::pmr::memory_resource* resource, const int depth, std::vector<std::pair<int, int>>* witness,
+        RecursionCounters& counters) const;
     void computeMinAndMaxSegmentsAttachments(const SegmentsHandler& segmentsHandler,
         int segmentsMinAttachment[], int segmentsMaxAttachment[]) const;
-    std::vector<int> computeOrder(const Node* cycleNode, const std::vector<int>& segmentsIndexes,
+    std::vector<int> computeOrder(const std::vector<int>& segmentsIndexes,
         int segmentsMinAttachment[], int segmentsMaxAttachment[], const SegmentsHandler& segmentsHandler, int cycleNodePosition) const;
     std::vector<bool> compatibilityEmbeddingsAndCycle(const SubGraph* component, const Cycle* cycle,
         const std::vector<std::unique_ptr<const Embedding>>& embeddings, const SegmentsHandler& segmentsHandler) const;
     void addMiddleEdges(const Segment* segment, const Embedding* embedding, int cycleNodeIndex,
         const SubGraph* component, bool compatible, Embedding* output) const;
+    void addChordEdge(const Chord& chord, const Cycle* cycle, int cycleNodePosition, Embedding* output) const;
     const Embedding* mergeSegmentsEmbeddings(const SubGraph* component, const Cycle* cycle,
         const std::vector<std::unique_ptr<const Embedding>>& embeddings, const SegmentsHandler& segmentsHandler,
-        const std::vector<int>& bipartition) const;
-    const Embedding* mergeBiconnectedComponents(const Graph* graph, const BiconnectedComponentsHandler& biconnectedComponents,
+        const std::vector<int>& bipartition, std::pmr::memory_resource* resource) const;
+    const Embedding* mergeBiconnectedComponents(const Graph* graph, const BlockCutTree& blockCutTree,
         const std::vector<std::unique_ptr<const Embedding>>& embeddings) const;
+    std::vector<std::pair<int, int>> computeWitness(const SubGraph* component, const Cycle* cycle,
+        const SegmentsHandler& segmentsHandler, const std::vector<int>& oddCycle) const;
 public:
-    std::optional<const Embedding*> embedGraph(const Graph* graph) const;
+    Embedder(const int numberOfThreads = 1, const CycleSelection cycleSelection = FIRST_FOUND_CYCLE,
+        const PlanarityAlgorithm algorithm = AUSLANDER_PARTER);
+    std::optional<const Embedding*> embedGraph(const Graph* graph,
+        std::vector<std::pair<int, int>>* witness = nullptr, RecursionCounters* counters = nullptr) const;
+    std::optional<const Embedding*> embedGraph(const Graph* graph, const BlockCutTree& blockCutTree,
+        std::vector<std::pair<int, int>>* witness = nullptr, RecursionCounters* counters = nullptr) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "halfEdgeEmbedding.hpp"
+
+#include <cassert>
+
+/**
+ * @brief Builds the half-edge representation of an embedding in O(n + m) time.
+ * 
+ * Nodes are visited by increasing index. An edge gets its id when it is first
+ * met, from its smaller endpoint, and the reverse dart is queued on the other
+ * endpoint; when that endpoint is visited, its queued darts are found through a
+ * marker array indexed by the neighbor.
+ * 
+ * @param embedding The embedding, where the neighbors of each node are listed in
+ * rotation order (e.g. an Embedding).
+ */
+HalfEdgeEmbedding::HalfEdgeEmbedding(const Graph* embedding) {
+    const int numberOfNodes = embedding->size();
+    std::vector<int> pendingOffsets(numberOfNodes+1, 0);
+    int numberOfDarts = 0;
+    for (int i = 0; i < numberOfNodes; ++i) {
+        const NeighborsRange neighbors = embedding->getNode(i)->getNeighbors();
+        numberOfDarts += neighbors.size();
+        for (int j = 0; j < neighbors.size(); ++j)
+            if (neighbors.getIndex(j) < i)
+                ++pendingOffsets[i+1];
+    }
+    assert(numberOfDarts % 2 == 0);
+    for (int i = 0; i < numberOfNodes; ++i)
+        pendingOffsets[i+1] += pendingOffsets[i];
+    std::vector<int> pendingDarts(pendingOffsets[numberOfNodes]);
+    std::vector<int> pendingSize(numberOfNodes, 0);
+    std::vector<int> marker(numberOfNodes, -1);
+    std::vector<int> rotation{};
+    head_m.resize(numberOfDarts);
+    next_m.resize(numberOfDarts);
+    rotationPosition_m.resize(numberOfDarts);
+    firstDart_m.assign(numberOfNodes, -1);
+    int nextEdge = 0;
+    for (int i = 0; i < numberOfNodes; ++i) {
+        for (int k = 0; k < pendingSize[i]; ++k) {
+            const int dart = pendingDarts[pendingOffsets[i]+k];
+            marker[head_m[dart]] = dart;
+        }
+        const NeighborsRange neighbors = embedding->getNode(i)->getNeighbors();
+        rotation.resize(neighbors.size());
+        for (int j = 0; j < neighbors.size(); ++j) {
+            const int neighbor = neighbors.getIndex(j);
+            assert(neighbor != i);
+            int dart;
+            if (neighbor > i) {
+                dart = 2*nextEdge++;
+                head_m[dart] = neighbor;
+                head_m[dart^1] = i;
+                pendingDarts[pendingOffsets[neighbor] + pendingSize[neighbor]++] = dart^1;
+            } else {
+                dart = marker[neighbor];
+                assert(dart != -1 && head_m[dart^1] == i && head_m[dart] == neighbor);
+            }
+            rotationPosition_m[dart] = j;
+            rotation[j] = dart;
+        }
+        for (int j = 0; j < (int)rotation.size(); ++j)
+            next_m[rotation[j]] = rotation[(j+1) % rotation.size()];
+        if (!rotation.empty())
+            firstDart_m[i] = rotation[0];
+    }
+    assert(2*nextEdge == numberOfDarts);
+}
+
+/**
+ * @brief Gets the number of nodes of the embedding.
+ * 
+ * @return int The number of nodes.
+ */
+int HalfEdgeEmbedding::size() const {
+    return firstDart_m.size();
+}
+
+/**
+ * @brief Gets the number of (undirected) edges of the embedding.
+ * 
+ * @return int The number of edges.
+ */
+int HalfEdgeEmbedding::numberOfEdges() const {
+    return head_m.size()/2;
+}
+
+/**
+ * @brief Gets the number of darts of the embedding, twice the number of edges.
+ * 
+ * @return int The number of darts.
+ */
+int HalfEdgeEmbedding::numberOfDarts() const {
+    return head_m.size();
+}
+
+/**
+ * @brief Gets the id of the edge a dart belongs to.
+ * 
+ * @param dart The dart.
+ * @return int The id of the edge.
+ */
+int HalfEdgeEmbedding::getEdge(const int dart) const {
+    return dart >> 1;
+}
+
+/**
+ * @brief Gets the dart of the same edge in the opposite direction.
+ * 
+ * @param dart The dart.
+ * @return int The twin dart.
+ */
+int HalfEdgeEmbedding::getTwin(const int dart) const {
+    return dart ^ 1;
+}
+
+/**
+ * @brief Gets the node a dart points to.
+ * 
+ * @param dart The dart.
+ * @return int The index of the head node.
+ */
+int HalfEdgeEmbedding::getHead(const int dart) const {
+    return head_m[dart];
+}
+
+/**
+ * @brief Gets the node a dart leaves from.
+ * 
+ * @param dart The dart.
+ * @return int The index of the tail node.
+ */
+int HalfEdgeEmbedding::getTail(const int dart) const {
+    return head_m[dart ^ 1];
+}
+
+/**
+ * @brief Gets the dart following the given one in the rotation of its tail node.
+ * 
+ * @param dart The dart.
+ * @return int The next dart leaving the same node.
+ */
+int HalfEdgeEmbedding::getNext(const int dart) const {
+    return next_m[dart];
+}
+
+/**
+ * @brief Gets the dart following the given one along the boundary of its face.
+ * 
+ * @param dart The dart.
+ * @return int The next dart of the face.
+ */
+int HalfEdgeEmbedding::getNextInFace(const int dart) const {
+    return next_m[dart ^ 1];
+}
+
+/**
+ * @brief Gets the position of a dart in the rotation of its tail node, which is
+ * the position of the head in the neighbors of the tail in the source embedding.
+ * 
+ * @param dart The dart.
+ * @return int The position in the rotation.
+ */
+int HalfEdgeEmbedding::getRotationPosition(const int dart) const {
+    return rotationPosition_m[dart];
+}
+
+/**
+ * @brief Gets the first dart in the rotation of a node.
+ * 
+ * @param nodeIndex The index of the node.
+ * @return int The first dart leaving the node, or -1 if the node is isolated.
+ */
+int HalfEdgeEmbedding::getFirstDart(const int nodeIndex) const {
+    return firstDart_m[nodeIndex];
+}
+
+/**
+ * @brief Counts the faces of the embedding by traversing every face once.
+ * 
+ * @return int The number of faces.
+ */
+int HalfEdgeEmbedding::computeNumberOfFaces() const {
+    std::vector<bool> isDartVisited(numberOfDarts(), false);
+    int numberOfFaces = 0;
+    for (int dart = 0; dart < numberOfDarts(); ++dart) {
+        if (isDartVisited[dart]) continue;
+        ++numberOfFaces;
+        int current = dart;
+        while (!isDartVisited[current]) {
+            isDartVisited[current] = true;
+            current = getNextInFace(current);
+        }
+    }
+    return numberOfFaces;
+}
@@ -0,0 +1,46 @@
+#ifndef MY_HALF_EDGE_EMBEDDING_H
+#define MY_HALF_EDGE_EMBEDDING_H
+
+#include <vector>
+
+#include "../basic/graph.hpp"
+
+/**
+ * @class HalfEdgeEmbedding
+ * @brief Half-edge (dart) representation of a combinatorial embedding.
+ * 
+ * Every undirected edge has a stable id e, in [0, numberOfEdges), and two darts
+ * 2e and 2e+1, one per direction, so the twin of a dart is found by flipping its
+ * lowest bit. Each dart stores its head node, its position in the rotation of its
+ * tail node and the next dart leaving the same node in rotation order. Faces are
+ * traversed with getNextInFace, without any per-node lookup.
+ * 
+ * Dart 2e always leaves the endpoint of edge e met first by the constructor, i.e.
+ * the one with the smaller index.
+ * 
+ * @note The embedding must be a simple graph whose rotations are consistent, as
+ * produced by the embedders: every neighbor v of u must have u as a neighbor.
+ */
+class HalfEdgeEmbedding {
+private:
+    std::vector<int> head_m{};
+    std::vector<int> next_m{};
+    std::vector<int> rotationPosition_m{};
+    std::vector<int> firstDart_m{};
+public:
+    HalfEdgeEmbedding(const Graph* embedding);
+    int size() const;
+    int numberOfEdges() const;
+    int numberOfDarts() const;
+    int getEdge(const int dart) const;
+    int getTwin(const int dart) const;
+    int getHead(const int dart) const;
+    int getTail(const int dart) const;
+    int getNext(const int dart) const;
+    int getNextInFace(const int dart) const;
+    int getRotationPosition(const int dart) const;
+    int getFirstDart(const int nodeIndex) const;
+    int computeNumberOfFaces() const;
+};
+
+#endif
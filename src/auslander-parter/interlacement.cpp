@@ -1,89 +1,322 @@
 #include "interlacement.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <numeric>
 
 /**
  * @brief Constructs an InterlacementGraph object.
  * 
  * This constructor initializes an InterlacementGraph with a given cycle and segments handler.
- * It computes conflicts between segments.
+ * The conflicts between segments are computed only by computeBipartition.
  * 
  * @param cycle Pointer to a Cycle object representing the cycle to be used.
  * @param segmentsHandler Reference to a SegmentsHandler object managing the segments.
  */
 InterlacementGraph::InterlacementGraph(const Cycle* cycle, const SegmentsHandler& segmentsHandler)
-    : Graph(segmentsHandler.size()), cycle_m(cycle) , segmentsHandler_m(segmentsHandler) {
-    computeConflicts();
+    : cycle_m(cycle) , segmentsHandler_m(segmentsHandler) {}
+
+/**
+ * @brief Computes a bipartition of the interlacement graph.
+ *
+ * Two segments are in conflict if any of their non-cycle edges may intersect, and
+ * segments in conflict must be placed on different sides of the cycle. In each connected
+ * component of the interlacement graph, the segment with the lowest index is placed on
+ * side 0.
+ *
+ * @param oddCycle If not null and the graph is not bipartite, filled with the indices of
+ *        segments forming an odd cycle of conflicts, each in conflict with the next one
+ *        and the last with the first.
+ * @return std::optional<std::vector<int>> The side (0 or 1) of each segment, or std::nullopt
+ * if the interlacement graph is not bipartite.
+ */
+std::optional<std::vector<int>> InterlacementGraph::computeBipartition(std::vector<int>* oddCycle) const {
+    InterlacementSweep sweep;
+    for (int i = 0; i < segmentsHandler_m.size(); ++i) {
+        for (int k = 0; k < segmentsHandler_m.getNumberOfAttachments(i); ++k)
+            sweep.addAttachment(segmentsHandler_m.getAttachmentPosition(i, k));
+        sweep.closeSegment();
+    }
+    ParityUnionFind unionFind(segmentsHandler_m.size());
+    std::vector<std::pair<int, int>> forest{};
+    std::pair<int, int> lastConflict{-1, -1};
+    const bool isBipartite = sweep.visitInterlacedPairs([&](int segment1, int segment2) {
+        lastConflict = {segment1, segment2};
+        if (oddCycle != nullptr && !unionFind.areInSameSet(segment1, segment2))
+            forest.push_back({segment1, segment2});
+        return unionFind.addDifferentSidesConstraint(segment1, segment2);
+    });
+    if (!isBipartite) {
+        if (oddCycle != nullptr) // the two segments have the same parity: an even path joins them
+            *oddCycle = computeForestPath(forest, lastConflict.first, lastConflict.second);
+        return std::nullopt;
+    }
+    return unionFind.computeBipartition();
 }
 
 /**
- * @brief Computes the cycle labels for the nodes in the interlacement graph.
+ * @brief Computes the path between two segments in a forest of conflicts.
  *
- * This function assigns labels to the nodes in the interlacement graph based on
- * their attachment status and their position within the cycle. The labels are used
- * to quickly determine conflicts between segments.
+ * @param forest The edges of the forest, as pairs of segment indices.
+ * @param from The first segment.
+ * @param to The last segment, in the same tree of the forest as from.
+ * @return std::vector<int> The segments of the path, from first to to last.
+ */
+std::vector<int> InterlacementGraph::computeForestPath(const std::vector<std::pair<int, int>>& forest,
+const int from, const int to) const {
+    std::vector<std::vector<int>> neighbors(segmentsHandler_m.size());
+    for (const auto& [segment1, segment2] : forest) {
+        neighbors[segment1].push_back(segment2);
+        neighbors[segment2].push_back(segment1);
+    }
+    std::vector<int> previous(segmentsHandler_m.size(), -1);
+    previous[from] = from;
+    std::vector<int> stack{from};
+    while (!stack.empty() && previous[to] == -1) {
+        const int segment = stack.back();
+        stack.pop_back();
+        for (const int neighbor : neighbors[segment]) {
+            if (previous[neighbor] != -1) continue;
+            previous[neighbor] = segment;
+            stack.push_back(neighbor);
+        }
+    }
+    assert(previous[to] != -1);
+    std::vector<int> path{to};
+    while (path.back() != from)
+        path.push_back(previous[path.back()]);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+/**
+ * @brief Adds an attachment to the segment being built.
  *
- * @param segment A pointer to the Segment object containing the attachments.
- * @param cycleLabels An array to store the computed cycle labels for each node.
+ * @param cyclePosition The position in the cycle of the attachment.
  */
-void InterlacementGraph::computeCycleLabels(const Segment* segment, int cycleLabels[]) {
-    int originalComponentSize = cycle_m->getOriginalComponentSize();
-    bool isCycleNodeAnAttachment[originalComponentSize];
-    for (int i = 0; i < originalComponentSize; ++i)
-        isCycleNodeAnAttachment[i] = false;
-    for (const Node* attachment : segment->getAttachments())
-        isCycleNodeAnAttachment[segment->getComponentNode(attachment)->getIndex()] = true;
-    int foundAttachments = 0;
-    int totalAttachments = segment->getAttachments().size();
-    for (int i = 0; i < cycle_m->size(); ++i) {
-        const Node* node = cycle_m->getNode(i);
-        if (isCycleNodeAnAttachment[node->getIndex()])
-            cycleLabels[node->getIndex()] = 2*(foundAttachments++);
-        else
-            if (foundAttachments == 0)
-                cycleLabels[node->getIndex()] = 2*totalAttachments-1;
-            else
-                cycleLabels[node->getIndex()] = 2*foundAttachments-1;
+void InterlacementSweep::addAttachment(const int cyclePosition) {
+    positions_m.push_back(cyclePosition);
+}
+
+/**
+ * @brief Closes the segment being built, the next attachments belong to a new segment.
+ *
+ * Segments are indexed in the order in which they are closed.
+ */
+void InterlacementSweep::closeSegment() {
+    offsets_m.push_back(positions_m.size());
+}
+
+/**
+ * @brief Returns the number of closed segments.
+ *
+ * @return int The number of segments.
+ */
+int InterlacementSweep::size() const {
+    return offsets_m.size()-1;
+}
+
+/**
+ * @brief Finds the root of an element in a forest of parent links, halving the path to it.
+ *
+ * @param parent The parent of each element, the roots being their own parent.
+ * @param element The element.
+ * @return int The root of the element.
+ */
+static int findRoot(std::vector<int>& parent, int element) {
+    while (parent[element] != element) {
+        parent[element] = parent[parent[element]];
+        element = parent[element];
     }
-    assert(foundAttachments == totalAttachments);
+    return element;
 }
 
 /**
- * @brief Computes conflicts between segments.
+ * @brief Finds the pairs of interlaced segments needed to place the segments on the two
+ * sides of the cycle, handing each of them to a visitor.
+ *
+ * Segments with less than two attachments are never interlaced. The segments with the same
+ * lo are opened by decreasing hi, then by decreasing second attachment, so that a segment
+ * opened later is in conflict with an earlier one exactly when the earlier one has an
+ * attachment strictly inside its (lo, hi), as if its lo were slightly after the earlier lo.
+ * At each position, the segments whose hi is there are closed first, then the attachments
+ * there are checked against the segments still open, and only then the new segments open.
+ * The open segments are numbered in order of opening, and a closed segment stays in its
+ * block, so that the segments opened after it can still be found.
  *
- * This function computes conflicts between segments based on their attachments and
- * their position within the cycle. Two segments are in conflict if any of their non-cycle
- * edges may intersect.
+ * @param visit Called for interlaced pairs of segments, the one opened first given first;
+ * each interlaced pair of segments is forced on different sides by the visited ones, if
+ * these are all placed on different sides. Returning false stops the sweep.
+ * @return true if all the needed pairs were visited, false if the visitor stopped the sweep.
  */
-void InterlacementGraph::computeConflicts() {
-    int cycleLabels[cycle_m->getOriginalComponentSize()];
-    for (int i = 0; i < segmentsHandler_m.size()-1; ++i) {
-        const Segment* segment = segmentsHandler_m.getSegment(i);
-        computeCycleLabels(segment, cycleLabels);
-        int numberOfLabels = 2*segment->getAttachments().size();
-        int labels[numberOfLabels];
-        for (int j = i+1; j < segmentsHandler_m.size(); ++j) {
-            const Segment* otherSegment = segmentsHandler_m.getSegment(j);
-            for (int k = 0; k < numberOfLabels; ++k)
-                labels[k] = 0;
-            for (const Node* attachment : otherSegment->getAttachments()) {
-                int attachmentComponent = otherSegment->getComponentNode(attachment)->getIndex();
-                labels[cycleLabels[attachmentComponent]] = 1;
+bool InterlacementSweep::visitInterlacedPairs(const std::function<bool(int, int)>& visit) {
+    const int numberOfSegments = size();
+    std::vector<int> first(numberOfSegments);
+    std::vector<int> second(numberOfSegments);
+    std::vector<int> last(numberOfSegments);
+    std::vector<int> segments{}; // the segments that can be interlaced, in order of opening
+    int numberOfPositions = 0;
+    for (int i = 0; i < numberOfSegments; ++i) {
+        first[i] = second[i] = last[i] = -1;
+        for (int k = offsets_m[i]; k < offsets_m[i+1]; ++k) {
+            const int position = positions_m[k];
+            if (first[i] == -1 || position < first[i]) {
+                second[i] = first[i];
+                first[i] = position;
+            } else if (second[i] == -1 || position < second[i]) {
+                second[i] = position;
             }
-            int sum = 0;
-            for (int k = 0; k < numberOfLabels; ++k)
-                sum += labels[k];
-            int partSum = labels[0] + labels[1] + labels[2];
-            bool areInConflict = true;
-            for (int k = 0; k <= numberOfLabels-2; k += 2) {
-                if (partSum == sum) {
-                    areInConflict = false;
-                    break;
-                }
-                partSum = partSum + labels[(3+k) % numberOfLabels] + labels[(4+k) % numberOfLabels];
-                partSum = partSum - labels[k] - labels[(1+k) % numberOfLabels];
+            last[i] = std::max(last[i], position);
+        }
+        if (second[i] == -1 || last[i] == first[i]) continue;
+        segments.push_back(i);
+        numberOfPositions = std::max(numberOfPositions, last[i]+1);
+    }
+    std::sort(segments.begin(), segments.end(), [&](int a, int b) {
+        if (first[a] != first[b]) return first[a] < first[b];
+        if (last[a] != last[b]) return last[a] > last[b];
+        if (second[a] != second[b]) return second[a] > second[b];
+        return a < b;
+    });
+    const int numberOfOpenable = segments.size();
+    std::vector<int> rank(numberOfSegments, -1);
+    for (int r = 0; r < numberOfOpenable; ++r)
+        rank[segments[r]] = r;
+    // attachments after the lo of each segment, bucketed by position
+    std::vector<int> attachmentsOffsets(numberOfPositions+1, 0);
+    for (int segment : segments)
+        for (int k = offsets_m[segment]; k < offsets_m[segment+1]; ++k)
+            if (positions_m[k] != first[segment]) ++attachmentsOffsets[positions_m[k]+1];
+    for (int p = 0; p < numberOfPositions; ++p)
+        attachmentsOffsets[p+1] += attachmentsOffsets[p];
+    std::vector<int> attachments(attachmentsOffsets[numberOfPositions]);
+    std::vector<int> filled(attachmentsOffsets.begin(), attachmentsOffsets.end()-1);
+    for (int segment : segments)
+        for (int k = offsets_m[segment]; k < offsets_m[segment+1]; ++k)
+            if (positions_m[k] != first[segment]) attachments[filled[positions_m[k]]++] = segment;
+    // nextOpen links each closed rank to the next one, blockParent links each rank to the
+    // first rank of its block, and blocks holds the first rank of each block, bottom first
+    std::vector<int> nextOpen(numberOfOpenable+1);
+    std::vector<int> blockParent(numberOfOpenable);
+    std::iota(nextOpen.begin(), nextOpen.end(), 0);
+    std::iota(blockParent.begin(), blockParent.end(), 0);
+    std::vector<int> blocks{};
+    int numberOfOpened = 0;
+    for (int p = 0; p < numberOfPositions; ++p) {
+        for (int k = attachmentsOffsets[p]; k < attachmentsOffsets[p+1]; ++k)
+            if (last[attachments[k]] == p) nextOpen[rank[attachments[k]]] = rank[attachments[k]]+1;
+        for (int k = attachmentsOffsets[p]; k < attachmentsOffsets[p+1]; ++k) {
+            const int segment = attachments[k];
+            const int block = findRoot(blockParent, rank[segment]);
+            int end = numberOfOpened;
+            int merged = -1;
+            while (blocks.back() > block) {
+                const int start = blocks.back();
+                blocks.pop_back();
+                const int open = findRoot(nextOpen, start);
+                if (open < end && !visit(segment, segments[open])) return false;
+                if (merged != -1) blockParent[merged] = start;
+                merged = start;
+                end = start;
             }
-            if (areInConflict) addEdge(i, j);
+            const int open = findRoot(nextOpen, rank[segment]+1);
+            if (open < end && !visit(segment, segments[open])) return false;
+            if (merged != -1) blocks.push_back(merged);
         }
+        while (numberOfOpened < numberOfOpenable && first[segments[numberOfOpened]] == p)
+            blocks.push_back(numberOfOpened++);
+    }
+    return true;
+}
+
+/**
+ * @brief Constructs a ParityUnionFind where each element is alone in its set.
+ *
+ * @param size The number of elements.
+ */
+ParityUnionFind::ParityUnionFind(const int size) : parent_m(size), parity_m(size, 0), rank_m(size, 0) {
+    for (int i = 0; i < size; ++i)
+        parent_m[i] = i;
+}
+
+/**
+ * @brief Finds the root of the set of an element, compressing the path to it.
+ *
+ * @param element The element.
+ * @param parity Set to the parity of the element with respect to the root.
+ * @return int The root of the set.
+ */
+int ParityUnionFind::find(const int element, int& parity) {
+    int root = element;
+    int rootParity = 0;
+    while (parent_m[root] != root) {
+        rootParity ^= parity_m[root];
+        root = parent_m[root];
+    }
+    int current = element;
+    int currentParity = rootParity;
+    while (current != root) {
+        const int next = parent_m[current];
+        const int nextParity = currentParity ^ parity_m[current];
+        parent_m[current] = root;
+        parity_m[current] = currentParity;
+        current = next;
+        currentParity = nextParity;
+    }
+    parity = rootParity;
+    return root;
+}
+
+/**
+ * @brief Checks if two elements are in the same set.
+ *
+ * @param element1 The first element.
+ * @param element2 The second element.
+ * @return true if the elements are in the same set, false otherwise.
+ */
+bool ParityUnionFind::areInSameSet(const int element1, const int element2) {
+    int parity1;
+    int parity2;
+    return find(element1, parity1) == find(element2, parity2);
+}
+
+/**
+ * @brief Adds the constraint that two elements must be on different sides.
+ *
+ * @param element1 The first element.
+ * @param element2 The second element.
+ * @return true if the constraint is consistent with the previous ones, false otherwise.
+ */
+bool ParityUnionFind::addDifferentSidesConstraint(const int element1, const int element2) {
+    int parity1;
+    int parity2;
+    int root1 = find(element1, parity1);
+    int root2 = find(element2, parity2);
+    if (root1 == root2) return parity1 != parity2;
+    if (rank_m[root1] < rank_m[root2]) std::swap(root1, root2);
+    parent_m[root2] = root1;
+    parity_m[root2] = parity1 ^ parity2 ^ 1;
+    if (rank_m[root1] == rank_m[root2]) ++rank_m[root1];
+    return true;
+}
+
+/**
+ * @brief Computes the side of each element.
+ *
+ * In each set, the element with the lowest index is placed on side 0, like a
+ * breadth-first search of the constraints started from the lowest unvisited element.
+ *
+ * @return std::vector<int> The side (0 or 1) of each element.
+ */
+std::vector<int> ParityUnionFind::computeBipartition() {
+    const int size = parent_m.size();
+    std::vector<int> bipartition(size);
+    std::vector<int> rootSide(size, -1); // side of the root, indexed by root
+    for (int i = 0; i < size; ++i) {
+        int parity;
+        const int root = find(i, parity);
+        if (rootSide[root] == -1) rootSide[root] = parity;
+        bipartition[i] = parity ^ rootSide[root];
     }
+    return bipartition;
 }
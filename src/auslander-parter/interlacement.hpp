@@ -1,30 +1,92 @@
 #ifndef MY_INTERLACEMENT_H
 #define MY_INTERLACEMENT_H
 
-#include "../basic/graph.hpp"
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
 #include "segment.hpp"
 #include "cycle.hpp"
 
+/**
+ * @class InterlacementSweep
+ * @brief Finds the conflicts between the segments of a cycle from the positions of their attachments.
+ *
+ * Two segments are interlaced (in conflict) unless all the attachments of one of them lie
+ * between two consecutive attachments of the other. With lo and hi the first and last
+ * attachment of a segment, this happens exactly when each segment has an attachment
+ * strictly inside (lo, hi) of the other. The cycle is swept by increasing position: a
+ * segment is opened at its lo and closed at its hi, and each of its other attachments is
+ * in conflict with exactly the segments opened after it and still open, which must all
+ * lie on the other side of the cycle. The open segments are kept on a stack of blocks of
+ * segments known to lie on the same side: at each attachment, the blocks above the one of
+ * its segment are checked against it and merged into a single block.
+ * Each block is merged once, so this takes O(A α(A) + k log k) time, for A attachments and
+ * k segments in total, whatever the number of interlaced pairs.
+ * Only the pairs that join or check two blocks are handed to a visitor: they are interlaced,
+ * and forcing them on different sides forces all the interlaced pairs on different sides.
+ */
+class InterlacementSweep {
+private:
+    std::vector<int> offsets_m{0};
+    std::vector<int> positions_m{};
+public:
+    void addAttachment(const int cyclePosition);
+    void closeSegment();
+    int size() const;
+    bool visitInterlacedPairs(const std::function<bool(int, int)>& visit);
+};
+
+/**
+ * @class ParityUnionFind
+ * @brief Union-find over the segments of a cycle, keeping for each element the parity
+ * of its side (inside or outside the cycle) with respect to its root.
+ *
+ * Each conflict between two segments is a constraint forcing them on different sides,
+ * and is merged into the structure as soon as it is found: a constraint between two
+ * elements already in the same set is checked against their parities, so an odd cycle
+ * of conflicts is detected without ever storing the conflicts.
+ * Union by rank and path compression keep each operation almost constant.
+ */
+class ParityUnionFind {
+private:
+    std::vector<int> parent_m;
+    std::vector<uint8_t> parity_m; // parity with respect to the parent
+    std::vector<uint8_t> rank_m;
+    int find(const int element, int& parity);
+public:
+    ParityUnionFind(const int size);
+    bool areInSameSet(const int element1, const int element2);
+    bool addDifferentSidesConstraint(const int element1, const int element2);
+    std::vector<int> computeBipartition();
+};
+
 /**
  * @class InterlacementGraph
- * @brief Represents a specialized graph used for analysis of conflicts between segments.
+ * @brief Represents the conflicts between the segments of a cycle.
  * 
- * Each node of the graph represents a segment of the cycle and each edge represents
- * a conflict between two segments.
+ * The interlacement graph has a node for each segment of the cycle and an edge for each
+ * conflict between two segments; the embedding needs a bipartition of it, which places
+ * the segments inside and outside the cycle. The graph is never built: the conflicts
+ * found by an InterlacementSweep are fed straight into a ParityUnionFind, stopping at
+ * the first conflict that makes the graph non bipartite.
+ * On request, the conflicts that merged two sets are kept as a spanning forest, so that
+ * the odd cycle closed by that first conflict can be reported.
  * 
- * @see Graph
  * @see Cycle
  * @see SegmentsHandler
  */
-class InterlacementGraph : public Graph {
+class InterlacementGraph {
 private:
     const Cycle* cycle_m;
     const SegmentsHandler& segmentsHandler_m;
-
-    void computeConflicts();
-    void computeCycleLabels(const Segment* segment, int cycleLabels[]);
+    std::vector<int> computeForestPath(const std::vector<std::pair<int, int>>& forest,
+        const int from, const int to) const;
 public:
     InterlacementGraph(const Cycle* cycle, const SegmentsHandler& segmentsHandler);
+    std::optional<std::vector<int>> computeBipartition(std::vector<int>* oddCycle = nullptr) const;
 };
 
 #endif
@@ -0,0 +1,195 @@
+#include "kuratowski.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <tuple>
+
+#include "../basic/graph.hpp"
+#include "leftRightPlanarity.hpp"
+
+/**
+ * @brief Constructs the finder for a graph given by its edges.
+ *
+ * The nodes may have any non negative labels. Loops and repeated edges are ignored.
+ *
+ * @param edges The edges of the graph, as pairs of node labels.
+ */
+KuratowskiFinder::KuratowskiFinder(const std::vector<std::pair<int, int>>& edges) {
+    for (const auto& [from, to] : edges) {
+        if (from == to) continue;
+        edges_m.push_back({std::min(from, to), std::max(from, to)});
+        labels_m.push_back(from);
+        labels_m.push_back(to);
+    }
+    std::sort(edges_m.begin(), edges_m.end());
+    edges_m.erase(std::unique(edges_m.begin(), edges_m.end()), edges_m.end());
+    std::sort(labels_m.begin(), labels_m.end());
+    labels_m.erase(std::unique(labels_m.begin(), labels_m.end()), labels_m.end());
+    auto nodeOfLabel = [this](int label) {
+        return std::lower_bound(labels_m.begin(), labels_m.end(), label) - labels_m.begin();
+    };
+    for (auto& [from, to] : edges_m) {
+        from = nodeOfLabel(from);
+        to = nodeOfLabel(to);
+    }
+}
+
+/**
+ * @brief Simplifies the branch edges once: drops loops and all but the shortest of
+ * parallel branch edges, removes the nodes of degree one (repeatedly), then joins the
+ * branch edges through nodes of degree two; cycles with no node of degree three or more
+ * are dropped.
+ *
+ * @return true if the number of branch edges decreased, false if nothing changed.
+ */
+bool KuratowskiFinder::reduceBranchEdges() {
+    const int numberOfNodes = labels_m.size();
+    const int initialNumberOfBranchEdges = branchEdges_m.size();
+    for (BranchEdge& branchEdge : branchEdges_m)
+        if (branchEdge.from > branchEdge.to) std::swap(branchEdge.from, branchEdge.to);
+    std::sort(branchEdges_m.begin(), branchEdges_m.end(), [](const BranchEdge& a, const BranchEdge& b) {
+        return std::make_tuple(a.from, a.to, a.edges.size()) < std::make_tuple(b.from, b.to, b.edges.size());
+    });
+    std::vector<BranchEdge> kept{};
+    for (BranchEdge& branchEdge : branchEdges_m) {
+        if (branchEdge.from == branchEdge.to) continue;
+        if (!kept.empty() && kept.back().from == branchEdge.from && kept.back().to == branchEdge.to) continue;
+        kept.push_back(std::move(branchEdge));
+    }
+    std::vector<std::vector<int>> incident(numberOfNodes);
+    std::vector<int> degree(numberOfNodes, 0);
+    for (int i = 0; i < kept.size(); ++i) {
+        incident[kept[i].from].push_back(i);
+        incident[kept[i].to].push_back(i);
+        ++degree[kept[i].from];
+        ++degree[kept[i].to];
+    }
+    // nodes of degree one
+    std::vector<bool> isRemoved(kept.size(), false);
+    std::vector<int> leaves{};
+    for (int node = 0; node < numberOfNodes; ++node)
+        if (degree[node] == 1) leaves.push_back(node);
+    while (!leaves.empty()) {
+        const int node = leaves.back();
+        leaves.pop_back();
+        if (degree[node] != 1) continue;
+        for (const int i : incident[node]) {
+            if (isRemoved[i]) continue;
+            isRemoved[i] = true;
+            const int other = kept[i].from == node ? kept[i].to : kept[i].from;
+            --degree[node];
+            --degree[other];
+            if (degree[other] == 1) leaves.push_back(other);
+            break;
+        }
+    }
+    // nodes of degree two
+    std::vector<BranchEdge> joined{};
+    std::vector<bool> isVisited(kept.size(), false);
+    for (int node = 0; node < numberOfNodes; ++node) {
+        if (degree[node] < 3) continue;
+        for (const int first : incident[node]) {
+            if (isRemoved[first] || isVisited[first]) continue;
+            BranchEdge branchEdge{node, -1};
+            int current = node;
+            int i = first;
+            while (true) {
+                isVisited[i] = true;
+                branchEdge.edges.insert(branchEdge.edges.end(), kept[i].edges.begin(), kept[i].edges.end());
+                current = kept[i].from == current ? kept[i].to : kept[i].from;
+                if (degree[current] != 2) break;
+                for (const int next : incident[current]) {
+                    if (isRemoved[next] || next == i) continue;
+                    i = next;
+                    break;
+                }
+            }
+            branchEdge.to = current;
+            joined.push_back(std::move(branchEdge));
+        }
+    }
+    branchEdges_m = std::move(joined);
+    return branchEdges_m.size() < initialNumberOfBranchEdges;
+}
+
+/**
+ * @brief Reduces the graph to its branch graph, where every node has degree at least
+ * three, and renumbers the nodes of the branch graph from 0.
+ */
+void KuratowskiFinder::computeBranchGraph() {
+    branchEdges_m.clear();
+    for (int i = 0; i < edges_m.size(); ++i)
+        branchEdges_m.push_back(BranchEdge{edges_m[i].first, edges_m[i].second, {i}});
+    while (reduceBranchEdges());
+}
+
+/**
+ * @brief Tests the planarity of the branch graph restricted to some of its edges.
+ *
+ * @param numberOfNodes The number of nodes of the branch graph.
+ * @param required Branch edges always included.
+ * @param candidates Branch edges of which only a prefix is included.
+ * @param numberOfCandidates The length of the prefix.
+ * @return true if the restricted branch graph is planar, false otherwise.
+ */
+bool KuratowskiFinder::isPlanar(const int numberOfNodes, const std::vector<int>& required,
+const std::vector<int>& candidates, const int numberOfCandidates) const {
+    Graph graph(numberOfNodes);
+    for (const int i : required)
+        graph.addEdge(branchEdges_m[i].from, branchEdges_m[i].to);
+    for (int k = 0; k < numberOfCandidates; ++k)
+        graph.addEdge(branchEdges_m[candidates[k]].from, branchEdges_m[candidates[k]].to);
+    LeftRightPlanarity test(&graph);
+    return test.isPlanar();
+}
+
+/**
+ * @brief Computes a subdivision of K5 or K3,3 contained in the graph.
+ *
+ * @return std::vector<std::pair<int, int>> The edges of the subdivision, as pairs of node
+ * labels (the lower label first), sorted; empty if the graph is planar.
+ */
+std::vector<std::pair<int, int>> KuratowskiFinder::computeSubdivision() {
+    computeBranchGraph();
+    // renumber the nodes left
+    std::vector<int> branchNode(labels_m.size(), -1);
+    int numberOfNodes = 0;
+    for (BranchEdge& branchEdge : branchEdges_m) {
+        for (int* node : {&branchEdge.from, &branchEdge.to}) {
+            if (branchNode[*node] == -1) branchNode[*node] = numberOfNodes++;
+            *node = branchNode[*node];
+        }
+    }
+    std::vector<int> required{};
+    std::vector<int> candidates(branchEdges_m.size());
+    for (int i = 0; i < candidates.size(); ++i)
+        candidates[i] = i;
+    if (numberOfNodes == 0 || isPlanar(numberOfNodes, required, candidates, candidates.size()))
+        return {};
+    // invariant: the required edges with all the candidates are not planar
+    while (!candidates.empty() && isPlanar(numberOfNodes, required, candidates, 0)) {
+        // shortest non planar prefix: first doubling its length, then bisecting
+        int low = 1;
+        int high = 1;
+        while (high < candidates.size() && isPlanar(numberOfNodes, required, candidates, high)) {
+            low = high+1;
+            high = std::min<int>(2*high, candidates.size());
+        }
+        while (low < high) {
+            const int middle = (low+high)/2;
+            if (isPlanar(numberOfNodes, required, candidates, middle)) low = middle+1;
+            else high = middle;
+        }
+        required.push_back(candidates[low-1]);
+        candidates.resize(low-1);
+    }
+    std::vector<std::pair<int, int>> subdivision{};
+    for (const int i : required) {
+        for (const int edge : branchEdges_m[i].edges) {
+            const auto& [from, to] = edges_m[edge];
+            subdivision.push_back({labels_m[from], labels_m[to]});
+        }
+    }
+    std::sort(subdivision.begin(), subdivision.end());
+    return subdivision;
+}
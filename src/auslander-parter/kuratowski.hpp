@@ -0,0 +1,43 @@
+#ifndef MY_KURATOWSKI_H
+#define MY_KURATOWSKI_H
+
+#include <utility>
+#include <vector>
+
+/**
+ * @class KuratowskiFinder
+ * @brief Finds a subdivision of K5 or K3,3 in a non-planar graph, given by its edges.
+ *
+ * Subdividing an edge does not change planarity, so the graph is first reduced to its
+ * branch graph: nodes of degree one are removed, paths through nodes of degree two
+ * become single branch edges, and loops and all but the shortest of parallel branch
+ * edges are dropped, until every node left has degree at least three.
+ * An edge-minimal non-planar subgraph of the branch graph is then grown one edge at a
+ * time: with the edges found so far, the shortest non-planar prefix of the remaining
+ * candidates is found with an exponential search, its last edge is needed, and the
+ * candidates after it are discarded. Each step takes O(log m) planarity tests with the
+ * LeftRightPlanarity test, so the whole search takes O(k m log m) time for a witness of
+ * k branch edges, m being the number of edges of the branch graph.
+ * An edge-minimal non-planar graph is a subdivision of K5 or K3,3 (Kuratowski), whose
+ * edges are given back as edges of the input graph.
+ */
+class KuratowskiFinder {
+private:
+    struct BranchEdge {
+        int from;
+        int to;
+        std::vector<int> edges{}; // indices in edges_m of the path
+    };
+    std::vector<int> labels_m{}; // label of each node in the input graph
+    std::vector<std::pair<int, int>> edges_m{};
+    std::vector<BranchEdge> branchEdges_m{};
+    bool reduceBranchEdges();
+    void computeBranchGraph();
+    bool isPlanar(const int numberOfNodes, const std::vector<int>& required,
+        const std::vector<int>& candidates, const int numberOfCandidates) const;
+public:
+    KuratowskiFinder(const std::vector<std::pair<int, int>>& edges);
+    std::vector<std::pair<int, int>> computeSubdivision();
+};
+
+#endif
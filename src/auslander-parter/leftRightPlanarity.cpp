@@ -0,0 +1,470 @@
+#include "leftRightPlanarity.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+/**
+ * @brief Checks if an interval of return edges is empty.
+ *
+ * @return true if the interval has neither a low nor a high edge, false otherwise.
+ */
+bool LeftRightPlanarity::Interval::isEmpty() const {
+    return low == -1 && high == -1;
+}
+
+/**
+ * @brief Swaps the left and the right interval of the conflict pair.
+ */
+void LeftRightPlanarity::ConflictPair::swap() {
+    std::swap(left, right);
+}
+
+/**
+ * @brief Constructs the planarity test of a graph.
+ *
+ * @param graph The graph to be tested and embedded, which must be simple.
+ */
+LeftRightPlanarity::LeftRightPlanarity(const Graph* graph) : graph_m(graph) {}
+
+/**
+ * @brief Orients the edges of the connected component of root with an iterative depth-first
+ * search, computing the height of each node and the lowpoints and nesting depth of each edge.
+ *
+ * Tree edges are oriented away from the root and back edges towards it. An edge met from
+ * its second endpoint (a node visited later, or the parent) is already oriented.
+ *
+ * @param root The root of the search, whose height must already be set to 0.
+ */
+void LeftRightPlanarity::orient(const int root) {
+    std::vector<int> stack{root};
+    while (!stack.empty()) {
+        const int node = stack.back();
+        stack.pop_back();
+        const int parentEdge = parentEdge_m[node];
+        const NeighborsRange neighbors = graph_m->getNode(node)->getNeighbors();
+        for (; nextNeighbor_m[node] < neighbors.size(); ++nextNeighbor_m[node]) {
+            const int slot = slotOffsets_m[node] + nextNeighbor_m[node];
+            const int neighbor = neighbors.getIndex(nextNeighbor_m[node]);
+            int edge = slotEdge_m[slot];
+            if (edge == -1) { // first time the edge is met from this node
+                if (neighbor == node) continue;
+                if (height_m[neighbor] > height_m[node]) continue;
+                if (parentEdge != -1 && edgeFrom_m[parentEdge] == neighbor) continue;
+                edge = edgeFrom_m.size();
+                slotEdge_m[slot] = edge;
+                edgeFrom_m.push_back(node);
+                edgeTo_m.push_back(neighbor);
+                lowpt_m.push_back(height_m[node]);
+                lowpt2_m.push_back(height_m[node]);
+                nestingDepth_m.push_back(0);
+                if (height_m[neighbor] == -1) { // tree edge
+                    parentEdge_m[neighbor] = edge;
+                    height_m[neighbor] = height_m[node]+1;
+                    stack.push_back(node); // the edge is completed when the node is visited again
+                    stack.push_back(neighbor);
+                    break;
+                }
+                lowpt_m[edge] = height_m[neighbor]; // back edge
+            }
+            nestingDepth_m[edge] = 2*lowpt_m[edge];
+            if (lowpt2_m[edge] < height_m[node]) // chordal
+                ++nestingDepth_m[edge];
+            if (parentEdge == -1) continue;
+            if (lowpt_m[edge] < lowpt_m[parentEdge]) {
+                lowpt2_m[parentEdge] = std::min(lowpt_m[parentEdge], lowpt2_m[edge]);
+                lowpt_m[parentEdge] = lowpt_m[edge];
+            }
+            else if (lowpt_m[edge] > lowpt_m[parentEdge])
+                lowpt2_m[parentEdge] = std::min(lowpt2_m[parentEdge], lowpt_m[edge]);
+            else
+                lowpt2_m[parentEdge] = std::min(lowpt2_m[parentEdge], lowpt2_m[edge]);
+        }
+    }
+}
+
+/**
+ * @brief Lists the outgoing edges of each node, in order of orientation, then sorts
+ * them by nesting depth (ties keep the order of orientation).
+ */
+void LeftRightPlanarity::sortOutEdgesByNestingDepth() {
+    const int numberOfNodes = graph_m->size();
+    outOffsets_m.assign(numberOfNodes+1, 0);
+    for (const int from : edgeFrom_m)
+        ++outOffsets_m[from+1];
+    for (int i = 0; i < numberOfNodes; ++i)
+        outOffsets_m[i+1] += outOffsets_m[i];
+    outEdges_m.resize(edgeFrom_m.size());
+    std::vector<int> positions(outOffsets_m.begin(), outOffsets_m.end()-1);
+    for (int edge = 0; edge < edgeFrom_m.size(); ++edge)
+        outEdges_m[positions[edgeFrom_m[edge]]++] = edge;
+    for (int i = 0; i < numberOfNodes; ++i)
+        std::stable_sort(outEdges_m.begin()+outOffsets_m[i], outEdges_m.begin()+outOffsets_m[i+1],
+            [this](int edge1, int edge2) { return nestingDepth_m[edge1] < nestingDepth_m[edge2]; });
+}
+
+/**
+ * @brief Checks if an interval contains a return edge conflicting with the given edge,
+ * i.e. returning higher than the lowpoint of the edge.
+ *
+ * @param interval The interval.
+ * @param edge The edge.
+ * @return true if the interval is not empty and its highest return edge conflicts with the edge.
+ */
+bool LeftRightPlanarity::isConflicting(const Interval& interval, const int edge) const {
+    if (interval.isEmpty()) return false;
+    assert(interval.high != -1);
+    return lowpt_m[interval.high] > lowpt_m[edge];
+}
+
+/**
+ * @brief Computes the lowest lowpoint among the return edges of a conflict pair.
+ *
+ * @param pair The conflict pair, which must not be empty.
+ * @return int The lowest lowpoint, as a height.
+ */
+int LeftRightPlanarity::computeLowest(const ConflictPair& pair) const {
+    assert(!pair.left.isEmpty() || !pair.right.isEmpty());
+    if (pair.left.isEmpty()) return lowpt_m[pair.right.low];
+    if (pair.right.isEmpty()) return lowpt_m[pair.left.low];
+    return std::min(lowpt_m[pair.left.low], lowpt_m[pair.right.low]);
+}
+
+/**
+ * @brief Tests the connected component of root with an iterative depth-first search,
+ * visiting the outgoing edges of each node by increasing nesting depth.
+ *
+ * @param root The root of the component.
+ * @return true if the constraints of the component can be satisfied, false if it is not planar.
+ */
+bool LeftRightPlanarity::test(const int root) {
+    std::vector<int> stack{root};
+    while (!stack.empty()) {
+        const int node = stack.back();
+        stack.pop_back();
+        const int parentEdge = parentEdge_m[node];
+        bool isNodeCompleted = true;
+        const int numberOfOutEdges = outOffsets_m[node+1]-outOffsets_m[node];
+        for (; nextNeighbor_m[node] < numberOfOutEdges; ++nextNeighbor_m[node]) {
+            const int edge = outEdges_m[outOffsets_m[node]+nextNeighbor_m[node]];
+            const int target = edgeTo_m[edge];
+            if (stackBottom_m[edge] == -1) { // first time the edge is met
+                stackBottom_m[edge] = stack_m.size();
+                if (edge == parentEdge_m[target]) { // tree edge
+                    stack.push_back(node); // the edge is completed when the node is visited again
+                    stack.push_back(target);
+                    isNodeCompleted = false;
+                    break;
+                }
+                lowptEdge_m[edge] = edge; // back edge
+                stack_m.push_back(ConflictPair{Interval{}, Interval{edge, edge}});
+            }
+            // integrate the new return edges
+            if (lowpt_m[edge] < height_m[node]) {
+                if (nextNeighbor_m[node] == 0)
+                    lowptEdge_m[parentEdge] = lowptEdge_m[edge];
+                else if (!addConstraints(edge, parentEdge))
+                    return false;
+            }
+        }
+        if (isNodeCompleted && parentEdge != -1)
+            removeBackEdges(parentEdge);
+    }
+    return true;
+}
+
+/**
+ * @brief Merges the return edges of an outgoing edge with the ones of the previous
+ * outgoing edges of the same node, adding the constraints between them.
+ *
+ * @param edge The outgoing edge, which has return edges and is not the first outgoing edge of its node.
+ * @param parentEdge The edge entering the node from its parent.
+ * @return true if the constraints can be satisfied, false if the graph is not planar.
+ */
+bool LeftRightPlanarity::addConstraints(const int edge, const int parentEdge) {
+    ConflictPair pair{};
+    // merge the return edges of edge into pair.right
+    do {
+        ConflictPair other = stack_m.back();
+        stack_m.pop_back();
+        if (!other.left.isEmpty()) other.swap();
+        if (!other.left.isEmpty()) return false;
+        if (lowpt_m[other.right.low] > lowpt_m[parentEdge]) { // merge the intervals
+            if (pair.right.isEmpty()) pair.right = other.right;
+            else ref_m[pair.right.low] = other.right.high;
+            pair.right.low = other.right.low;
+        }
+        else // align
+            ref_m[other.right.low] = lowptEdge_m[parentEdge];
+    } while (stack_m.size() != stackBottom_m[edge]);
+    // merge the conflicting return edges of the previous outgoing edges into pair.left
+    while (!stack_m.empty() && (isConflicting(stack_m.back().left, edge) || isConflicting(stack_m.back().right, edge))) {
+        ConflictPair other = stack_m.back();
+        stack_m.pop_back();
+        if (isConflicting(other.right, edge)) other.swap();
+        if (isConflicting(other.right, edge)) return false;
+        // merge the interval below the lowpoint of edge into pair.right
+        if (pair.right.low != -1) ref_m[pair.right.low] = other.right.high;
+        if (other.right.low != -1) pair.right.low = other.right.low;
+        if (pair.left.isEmpty()) pair.left = other.left;
+        else ref_m[pair.left.low] = other.left.high;
+        pair.left.low = other.left.low;
+    }
+    if (!pair.left.isEmpty() || !pair.right.isEmpty())
+        stack_m.push_back(pair);
+    return true;
+}
+
+/**
+ * @brief Removes from the conflict pairs the back edges ending at the source of an edge,
+ * once all its outgoing edges have been visited, and computes the reference of the edge
+ * to its highest return edge.
+ *
+ * @param edge The tree edge whose target has just been completed.
+ */
+void LeftRightPlanarity::removeBackEdges(const int edge) {
+    const int source = edgeFrom_m[edge];
+    // drop entire conflict pairs
+    while (!stack_m.empty() && computeLowest(stack_m.back()) == height_m[source]) {
+        const ConflictPair pair = stack_m.back();
+        stack_m.pop_back();
+        if (pair.left.low != -1) side_m[pair.left.low] = -1;
+    }
+    if (!stack_m.empty()) { // one more conflict pair to consider
+        ConflictPair pair = stack_m.back();
+        stack_m.pop_back();
+        // trim the left interval
+        while (pair.left.high != -1 && edgeTo_m[pair.left.high] == source)
+            pair.left.high = ref_m[pair.left.high];
+        if (pair.left.high == -1 && pair.left.low != -1) { // just emptied
+            ref_m[pair.left.low] = pair.right.low;
+            side_m[pair.left.low] = -1;
+            pair.left.low = -1;
+        }
+        // trim the right interval
+        while (pair.right.high != -1 && edgeTo_m[pair.right.high] == source)
+            pair.right.high = ref_m[pair.right.high];
+        if (pair.right.high == -1 && pair.right.low != -1) { // just emptied
+            ref_m[pair.right.low] = pair.left.low;
+            side_m[pair.right.low] = -1;
+            pair.right.low = -1;
+        }
+        stack_m.push_back(pair);
+    }
+    // the side of edge is the side of a highest return edge
+    if (lowpt_m[edge] < height_m[source]) {
+        const int highLeft = stack_m.back().left.high;
+        const int highRight = stack_m.back().right.high;
+        if (highLeft != -1 && (highRight == -1 || lowpt_m[highLeft] > lowpt_m[highRight]))
+            ref_m[edge] = highLeft;
+        else
+            ref_m[edge] = highRight;
+    }
+}
+
+/**
+ * @brief Computes the final side of an edge, following its chain of references.
+ *
+ * Every edge of the chain gets its final side, and its reference is cleared.
+ *
+ * @param edge The edge.
+ * @return int 1 if the edge is on the right, -1 if it is on the left.
+ */
+int LeftRightPlanarity::computeSign(const int edge) {
+    std::vector<int> chain{};
+    int current = edge;
+    while (ref_m[current] != -1) {
+        chain.push_back(current);
+        current = ref_m[current];
+    }
+    for (int i = chain.size()-1; i >= 0; --i) {
+        side_m[chain[i]] *= side_m[ref_m[chain[i]]];
+        ref_m[chain[i]] = -1;
+    }
+    return side_m[edge];
+}
+
+/**
+ * @brief Adds a dart to the rotation of its node, right after another dart in clockwise order.
+ *
+ * @param node The node the dart leaves.
+ * @param dart The dart to be added.
+ * @param reference The dart after which the new one is added, -1 if the rotation is empty.
+ */
+void LeftRightPlanarity::addDartClockwise(const int node, const int dart, const int reference) {
+    if (reference == -1) {
+        firstDart_m[node] = dart;
+        clockwise_m[dart] = dart;
+        counterClockwise_m[dart] = dart;
+        return;
+    }
+    const int next = clockwise_m[reference];
+    clockwise_m[reference] = dart;
+    counterClockwise_m[dart] = reference;
+    clockwise_m[dart] = next;
+    counterClockwise_m[next] = dart;
+}
+
+/**
+ * @brief Adds a dart to the rotation of its node, right before another dart in clockwise order.
+ *
+ * If the reference is the first dart of the node, the new dart becomes the first one.
+ *
+ * @param node The node the dart leaves.
+ * @param dart The dart to be added.
+ * @param reference The dart before which the new one is added, -1 if the rotation is empty.
+ */
+void LeftRightPlanarity::addDartCounterClockwise(const int node, const int dart, const int reference) {
+    if (reference == -1) {
+        addDartClockwise(node, dart, -1);
+        return;
+    }
+    addDartClockwise(node, dart, counterClockwise_m[reference]);
+    if (reference == firstDart_m[node])
+        firstDart_m[node] = dart;
+}
+
+/**
+ * @brief Completes the rotations of the connected component of root with an iterative
+ * depth-first search, adding the darts entering each node (from its parent and from its
+ * back edges) to the outgoing ones, already sorted by signed nesting depth.
+ *
+ * @param root The root of the component.
+ */
+void LeftRightPlanarity::embed(const int root) {
+    std::vector<int> stack{root};
+    while (!stack.empty()) {
+        const int node = stack.back();
+        stack.pop_back();
+        const int numberOfOutEdges = outOffsets_m[node+1]-outOffsets_m[node];
+        while (nextNeighbor_m[node] < numberOfOutEdges) {
+            const int edge = outEdges_m[outOffsets_m[node]+nextNeighbor_m[node]];
+            ++nextNeighbor_m[node];
+            const int target = edgeTo_m[edge];
+            if (edge == parentEdge_m[target]) { // tree edge
+                addDartCounterClockwise(target, 2*edge+1, firstDart_m[target]);
+                leftRef_m[node] = 2*edge;
+                rightRef_m[node] = 2*edge;
+                stack.push_back(node); // the remaining edges are visited when the node is visited again
+                stack.push_back(target);
+                break;
+            }
+            if (side_m[edge] == 1) // back edge
+                addDartClockwise(target, 2*edge+1, rightRef_m[target]);
+            else {
+                addDartCounterClockwise(target, 2*edge+1, leftRef_m[target]);
+                leftRef_m[target] = 2*edge+1;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Orients the graph and tests its connected components, stopping at the first
+ * non-planar one.
+ *
+ * The constraints that cannot be satisfied involve only the return edges met by the test
+ * so far, so the edges of the failing component met by then already form a non-planar
+ * subgraph, usually much smaller than the graph.
+ *
+ * @param nonPlanarEdges If not null and the graph is not planar, filled with the edges of
+ *        a non-planar subgraph, as pairs of node indices; the number of edges is then not
+ *        checked first, since it gives no subgraph.
+ * @return true if the graph is planar, false otherwise.
+ */
+bool LeftRightPlanarity::orientAndTest(std::vector<std::pair<int, int>>* nonPlanarEdges) {
+    const int numberOfNodes = graph_m->size();
+    if (nonPlanarEdges == nullptr && numberOfNodes > 2 && graph_m->numberOfEdges() > 3*numberOfNodes-6)
+        return false;
+    // orientation
+    slotOffsets_m.assign(numberOfNodes+1, 0);
+    for (int i = 0; i < numberOfNodes; ++i)
+        slotOffsets_m[i+1] = slotOffsets_m[i] + graph_m->getNode(i)->getNeighbors().size();
+    slotEdge_m.assign(slotOffsets_m[numberOfNodes], -1);
+    height_m.assign(numberOfNodes, -1);
+    parentEdge_m.assign(numberOfNodes, -1);
+    nextNeighbor_m.assign(numberOfNodes, 0);
+    for (int i = 0; i < numberOfNodes; ++i) {
+        if (height_m[i] != -1) continue;
+        height_m[i] = 0;
+        roots_m.push_back(i);
+        rootsFirstEdge_m.push_back(edgeFrom_m.size());
+        orient(i);
+    }
+    slotOffsets_m = std::vector<int>{};
+    slotEdge_m = std::vector<int>{};
+    lowpt2_m = std::vector<int>{};
+    // testing
+    const int numberOfEdges = edgeFrom_m.size();
+    sortOutEdgesByNestingDepth();
+    ref_m.assign(numberOfEdges, -1);
+    side_m.assign(numberOfEdges, 1);
+    lowptEdge_m.assign(numberOfEdges, -1);
+    stackBottom_m.assign(numberOfEdges, -1);
+    nextNeighbor_m.assign(numberOfNodes, 0);
+    rootsFirstEdge_m.push_back(numberOfEdges);
+    for (int i = 0; i < roots_m.size(); ++i) {
+        if (test(roots_m[i])) continue;
+        if (nonPlanarEdges != nullptr)
+            for (int edge = rootsFirstEdge_m[i]; edge < rootsFirstEdge_m[i+1]; ++edge)
+                if (stackBottom_m[edge] != -1)
+                    nonPlanarEdges->push_back({edgeFrom_m[edge], edgeTo_m[edge]});
+        return false;
+    }
+    stack_m = std::vector<ConflictPair>{};
+    stackBottom_m = std::vector<int>{};
+    lowptEdge_m = std::vector<int>{};
+    return true;
+}
+
+/**
+ * @brief Tests the graph for planarity, without computing an embedding.
+ *
+ * @return true if the graph is planar, false otherwise.
+ */
+bool LeftRightPlanarity::isPlanar() {
+    return orientAndTest(nullptr);
+}
+
+/**
+ * @brief Tests the graph for planarity and, if it is planar, computes an embedding of it.
+ *
+ * @param nonPlanarEdges If not null and the graph is not planar, filled with the edges of
+ *        a non-planar subgraph met by the test before it failed.
+ * @return An optional containing a pointer to the embedding if the graph is planar, or an
+ * empty optional otherwise.
+ */
+std::optional<const Embedding*> LeftRightPlanarity::computeEmbedding(std::vector<std::pair<int, int>>* nonPlanarEdges) {
+    if (!orientAndTest(nonPlanarEdges)) return std::nullopt;
+    const int numberOfNodes = graph_m->size();
+    const int numberOfEdges = edgeFrom_m.size();
+    for (int edge = 0; edge < numberOfEdges; ++edge)
+        nestingDepth_m[edge] *= computeSign(edge);
+    sortOutEdgesByNestingDepth();
+    firstDart_m.assign(numberOfNodes, -1);
+    clockwise_m.assign(2*numberOfEdges, -1);
+    counterClockwise_m.assign(2*numberOfEdges, -1);
+    for (int i = 0; i < numberOfNodes; ++i) {
+        int previous = -1;
+        for (int j = outOffsets_m[i]; j < outOffsets_m[i+1]; ++j) {
+            addDartClockwise(i, 2*outEdges_m[j], previous);
+            previous = 2*outEdges_m[j];
+        }
+    }
+    leftRef_m.assign(numberOfNodes, -1);
+    rightRef_m.assign(numberOfNodes, -1);
+    nextNeighbor_m.assign(numberOfNodes, 0);
+    for (const int root : roots_m)
+        embed(root);
+    Embedding* embedding = new Embedding(graph_m);
+    for (int i = 0; i < numberOfNodes; ++i) {
+        if (firstDart_m[i] == -1) continue;
+        int dart = firstDart_m[i];
+        do {
+            const int edge = dart/2;
+            embedding->addSingleEdge(i, dart % 2 == 0 ? edgeTo_m[edge] : edgeFrom_m[edge]);
+            dart = clockwise_m[dart];
+        } while (dart != firstDart_m[i]);
+    }
+    return embedding;
+}
@@ -0,0 +1,89 @@
+#ifndef MY_LEFT_RIGHT_PLANARITY_H
+#define MY_LEFT_RIGHT_PLANARITY_H
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "../basic/graph.hpp"
+#include "embedder.hpp"
+
+/**
+ * @class LeftRightPlanarity
+ * @brief Linear-time planarity test and embedding of a graph, with the left-right
+ * planarity criterion of de Fraysseix and Rosenstiehl, as described by Brandes.
+ *
+ * The edges are oriented by a depth-first search, which computes the lowpoints and the
+ * nesting depth of each edge. A second depth-first search, visiting the outgoing edges
+ * of each node by increasing nesting depth, keeps a stack of conflict pairs of return
+ * edges that must lie on different sides of the tree; the graph is planar if all the
+ * constraints can be satisfied. The sides found are then turned into the rotation of
+ * each node by a third depth-first search.
+ * All the searches are iterative, so the size of the graph is not limited by the call
+ * stack, and the whole computation takes O(n+m) time. Graphs with more than 3n-6 edges
+ * are rejected before any search, unless the edges of a non-planar subgraph are asked
+ * for: these are the edges met by the second search of the failing component before a
+ * constraint could not be satisfied, the constraints found so far involving no others.
+ *
+ * @note The graph must be simple, and only one of isPlanar and computeEmbedding may be
+ * called, only once.
+ */
+class LeftRightPlanarity {
+private:
+    struct Interval {
+        int low = -1;
+        int high = -1;
+        bool isEmpty() const;
+    };
+    struct ConflictPair {
+        Interval left{};
+        Interval right{};
+        void swap();
+    };
+    const Graph* graph_m;
+    std::vector<int> roots_m{};
+    std::vector<int> rootsFirstEdge_m{}; // first edge oriented from each root, the edges of a component being consecutive
+    std::vector<int> slotOffsets_m{}; // start of the neighbors of each node among all the neighbors
+    std::vector<int> slotEdge_m{}; // edge of each neighbor of each node, -1 until oriented from that side
+    std::vector<int> nextNeighbor_m{}; // where each node resumes in the depth-first searches
+    std::vector<int> height_m{};
+    std::vector<int> parentEdge_m{};
+    // edges, oriented by the first search, in the order of orientation
+    std::vector<int> edgeFrom_m{};
+    std::vector<int> edgeTo_m{};
+    std::vector<int> lowpt_m{};
+    std::vector<int> lowpt2_m{};
+    std::vector<int> nestingDepth_m{};
+    // outgoing edges of each node, sorted by nesting depth
+    std::vector<int> outOffsets_m{};
+    std::vector<int> outEdges_m{};
+    std::vector<int> ref_m{};
+    std::vector<int> side_m{};
+    std::vector<int> lowptEdge_m{};
+    std::vector<int> stackBottom_m{};
+    std::vector<ConflictPair> stack_m{};
+    // rotations, as circular lists of darts: dart 2e leaves the tail of edge e, dart 2e+1 its head
+    std::vector<int> firstDart_m{};
+    std::vector<int> clockwise_m{};
+    std::vector<int> counterClockwise_m{};
+    std::vector<int> leftRef_m{};
+    std::vector<int> rightRef_m{};
+    void orient(const int root);
+    void sortOutEdgesByNestingDepth();
+    bool test(const int root);
+    bool isConflicting(const Interval& interval, const int edge) const;
+    int computeLowest(const ConflictPair& pair) const;
+    bool addConstraints(const int edge, const int parentEdge);
+    void removeBackEdges(const int edge);
+    int computeSign(const int edge);
+    void addDartClockwise(const int node, const int dart, const int reference);
+    void addDartCounterClockwise(const int node, const int dart, const int reference);
+    void embed(const int root);
+    bool orientAndTest(std::vector<std::pair<int, int>>* nonPlanarEdges);
+public:
+    LeftRightPlanarity(const Graph* graph);
+    bool isPlanar();
+    std::optional<const Embedding*> computeEmbedding(std::vector<std::pair<int, int>>* nonPlanarEdges = nullptr);
+};
+
+#endif
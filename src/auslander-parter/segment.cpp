@@ -1,5 +1,6 @@
 #include "segment.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
 
@@ -9,17 +10,22 @@
  * This constructor initializes a Segment object with the given number of nodes,
  * a pointer to a SubGraph component, and a pointer to a Cycle. It also initializes
  * the component nodes pointers and sets all nodes as non-attachment nodes.
+ * The edges are stored directly in the compacted representation of the segment.
  * 
  * @param numberOfNodes The number of nodes in the segment.
  * @param component A pointer to the SubGraph component associated with this segment.
  * @param cycle A pointer to the Cycle associated with this segment.
+ * @param edges The edges of the segment (cycle edges included), as pairs of segment node indices.
+ * @param resource The memory resource the storage of the segment is allocated from.
  */
-Segment::Segment(const int numberOfNodes, const SubGraph* component, const Cycle* cycle)
-: SubGraph(numberOfNodes, component), originalComponent_m(component),
-originalCycle_m(cycle), componentNodesPointers_m(numberOfNodes) {
+Segment::Segment(const int numberOfNodes, const SubGraph* component, const Cycle* cycle,
+const std::vector<std::pair<int, int>>& edges, std::pmr::memory_resource* resource)
+: SubGraph(numberOfNodes, component, resource), attachmentNodes_m(resource), isNodeAnAttachment_m(resource),
+originalComponent_m(component), originalCycle_m(cycle), componentNodesPointers_m(numberOfNodes, resource) {
     isNodeAnAttachment_m.resize(numberOfNodes);
     for (int i = 0; i < numberOfNodes; ++i)
         isNodeAnAttachment_m[i] = false;
+    compactFromEdges(edges);
 }
 
 /**
@@ -60,7 +66,7 @@ bool Segment::isPath() const {
  * 
  * @return A constant reference to a vector of pointers to the attachment nodes.
  */
-const std::vector<const Node*>& Segment::getAttachments() const {
+const std::pmr::vector<const Node*>& Segment::getAttachments() const {
     return attachmentNodes_m;
 }
 
@@ -87,6 +93,8 @@ std::list<const Node*> Segment::computePathBetweenAttachments(const Node* start,
         const Node* node = queue.front();
         queue.pop_front();
         const Node* componentNode = getComponentNode(node);
+        if (node != start && originalCycle_m->hasNode(componentNode))
+            continue; // the path must not go through other attachments
         for (const Node* neighbor : node->getNeighbors()) {
             const Node* componentNeighbor = getComponentNode(neighbor);
             if (originalCycle_m->hasNode(componentNode) && originalCycle_m->hasNode(componentNeighbor))
@@ -163,11 +171,40 @@ void Segment::setComponentNode(const Node* node, const Node* componentNode) {
  * 
  * @param component Pointer to the SubGraph object representing the component.
  * @param cycle Pointer to the Cycle object representing the cycle.
+ * @param resource The memory resource the segments are allocated from.
  */
-SegmentsHandler::SegmentsHandler(const SubGraph* component, const Cycle* cycle)
-: originalComponent_m(component), originalCycle_m(cycle) {
+SegmentsHandler::SegmentsHandler(const SubGraph* component, const Cycle* cycle, std::pmr::memory_resource* resource)
+: originalCycle_m(cycle), originalComponent_m(component), resource_m(resource) {
     findSegments();
     findChords();
+    buildAttachmentsIndex();
+}
+
+/**
+ * @brief Constructs the segments of a cycle just changed with a path of its only segment.
+ *
+ * The previous cycle had a single segment, which is not a path, so it had no chords:
+ * every chord of the new cycle has an endpoint on the path that replaced part of the
+ * cycle (the endpoints of the path included, as the edge between them may have been
+ * removed from the cycle). So only the nodes of the path, and their neighbors on the
+ * cycle, are scanned for chords. The segments are found as in the other constructor
+ * rather than by splitting the old segment along the path: the new segments hold every
+ * node off the new cycle (the nodes of the old segment not on the path, and the inner
+ * nodes of the replaced part of the cycle), each copied into a new segment after the new
+ * cycle, so a split would visit the same nodes and edges as the search, which is linear
+ * in the component. Both the segments and the chords come in the same order as from scratch.
+ *
+ * @param component Pointer to the SubGraph object representing the component.
+ * @param cycle Pointer to the Cycle object representing the changed cycle.
+ * @param changedPath The path, as component nodes, the cycle has been changed with.
+ * @param resource The memory resource the segments are allocated from.
+ */
+SegmentsHandler::SegmentsHandler(const SubGraph* component, const Cycle* cycle,
+const std::list<const Node*>& changedPath, std::pmr::memory_resource* resource)
+: originalCycle_m(cycle), originalComponent_m(component), resource_m(resource) {
+    findSegments();
+    findChordsAroundPath(changedPath);
+    buildAttachmentsIndex();
 }
 
 /**
@@ -180,49 +217,81 @@ SegmentsHandler::SegmentsHandler(const SubGraph* component, const Cycle* cycle)
  * @param node The starting node for the DFS traversal.
  * @param isNodeVisited An array indicating whether each node has been visited.
  * @param nodesInSegment A vector to store the nodes that are part of the current segment.
- * @param edgesInSegment A vector to store the edges that are part of the current segment.
+ * @param edgesInSegment A vector to store the edges that are part of the current segment,
+ *                       as pairs of component node indices.
  */
 void SegmentsHandler::dfsFindSegments(const Node* node, bool isNodeVisited[], std::vector<const Node*>& nodesInSegment,
-std::vector<std::pair<const Node*, const Node*>>& edgesInSegment) {
+std::vector<std::pair<int, int>>& edgesInSegment) {
     int nodeIndex = node->getIndex();
     nodesInSegment.push_back(node);
     isNodeVisited[nodeIndex] = true;
     for (const Node* neighbor : node->getNeighbors()) {
         int neighborIndex = neighbor->getIndex();
         if (originalCycle_m->hasNode(neighbor)) {
-            edgesInSegment.push_back(std::make_pair(node, neighbor));
+            edgesInSegment.push_back(std::make_pair(nodeIndex, neighborIndex));
             continue;
         }
         if (nodeIndex < neighborIndex)
-            edgesInSegment.push_back(std::make_pair(node, neighbor));
+            edgesInSegment.push_back(std::make_pair(nodeIndex, neighborIndex));
         if (!isNodeVisited[neighborIndex])
             dfsFindSegments(neighbor, isNodeVisited, nodesInSegment, edgesInSegment);
     }
 }
 
 /**
- * @brief Finds and constructs chords in the original cycle.
+ * @brief Finds and records chords in the original cycle.
  * 
  * This function iterates through each node in the original cycle and checks its neighbors.
  * If a neighbor is part of the original cycle and is not the previous or next node in the cycle,
- * a chord is constructed between the node and the neighbor. 
+ * a chord is recorded between the node and the neighbor. 
  * 
  * @note A chord is defined as a segment connecting two non-adjacent nodes in the cycle.
  */
 void SegmentsHandler::findChords() {
-    for (int i = 0; i < originalCycle_m->size(); ++i) {
-        const Node* node = originalCycle_m->getNode(i);
-        for (const Node* neighbor : node->getNeighbors()) {
-            if (node->getIndex() < neighbor->getIndex()) continue;
-            if (originalCycle_m->hasNode(neighbor))
-                if (neighbor != originalCycle_m->getPrevOfNode(node) && neighbor != originalCycle_m->getNextOfNode(node)) {
-                    const Segment* chord = buildChord(node, neighbor);
-                    segments_m.push_back(std::unique_ptr<const Segment>(chord));
-                }
-        }
+    for (int i = 0; i < originalCycle_m->size(); ++i)
+        findChordsOfNode(originalCycle_m->getNode(i));
+}
+
+/**
+ * @brief Records the chords between a cycle node and the cycle nodes with a lower index.
+ *
+ * Each chord is recorded once, from its endpoint with the higher index.
+ *
+ * @param node The cycle node whose chords are recorded.
+ */
+void SegmentsHandler::findChordsOfNode(const Node* node) {
+    for (const Node* neighbor : node->getNeighbors()) {
+        if (node->getIndex() < neighbor->getIndex()) continue;
+        if (originalCycle_m->hasNode(neighbor))
+            if (neighbor != originalCycle_m->getPrevOfNode(node) && neighbor != originalCycle_m->getNextOfNode(node))
+                chords_m.push_back(Chord{originalCycle_m->getPositionOfNode(node).value(),
+                    originalCycle_m->getPositionOfNode(neighbor).value()});
     }
 }
 
+/**
+ * @brief Finds the chords of the cycle with an endpoint on the given path of the cycle.
+ *
+ * The nodes scanned by findChordsOfNode are the nodes of the path and their neighbors
+ * in the cycle with a higher index, visited in the order of the cycle, so that the
+ * chords come in the same order as from findChords.
+ *
+ * @param path The nodes of the path, which must all be in the cycle.
+ */
+void SegmentsHandler::findChordsAroundPath(const std::list<const Node*>& path) {
+    std::vector<int> positions{};
+    for (const Node* node : path) {
+        positions.push_back(originalCycle_m->getPositionOfNode(node).value());
+        for (const Node* neighbor : node->getNeighbors())
+            if (node->getIndex() < neighbor->getIndex() && originalCycle_m->hasNode(neighbor))
+                positions.push_back(originalCycle_m->getPositionOfNode(neighbor).value());
+    }
+    std::sort(positions.begin(), positions.end());
+    positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    for (int position : positions)
+        findChordsOfNode(originalCycle_m->getNode(position));
+}
+
 /**
  * @brief Finds segments in the original biconnected component. It uses a
  * depth-first search (DFS) to find these segments and then builds and stores them.
@@ -239,7 +308,7 @@ void SegmentsHandler::findSegments() {
         const Node* node = originalComponent_m->getNode(i);
         if (!isNodeVisited[i]) {
             std::vector<const Node*> nodes{}; // does NOT contain cycle nodes
-            std::vector<std::pair<const Node*, const Node*>> edges{}; // does NOT contain edges of the cycle
+            std::vector<std::pair<int, int>> edges{}; // does NOT contain edges of the cycle
             dfsFindSegments(node, isNodeVisited, nodes, edges);
             const Segment* segment = buildSegment(nodes, edges);
             segments_m.push_back(std::unique_ptr<const Segment>(segment));
@@ -252,104 +321,167 @@ void SegmentsHandler::findSegments() {
  *
  * This function creates a new Segment object that includes nodes from both the original cycle 
  * and the provided nodes vector. It sets up the necessary pointers and relationships between 
- * the new segment nodes and the original component nodes. Additionally, it adds edges between 
- * the nodes and handles attachments for nodes that are part of the original cycle.
+ * the new segment nodes and the original component nodes. Additionally, it relabels the edges,
+ * appends the cycle edges and handles attachments for nodes that are part of the original cycle.
  * The first nodes in the segment must be the same as the cycle nodes in the same order.
+ * The adjacency of the segment is stored once, directly in compacted form.
  * 
  * @note The nodes vector must not include the cycle nodes.
  * @note The edges vector must not contain cycle edges.
  *
  * @param nodes A vector of pointers to Node objects representing the nodes to be included in the segment.
  *              Note that this vector does not include the cycle nodes.
- * @param edges A vector of pairs of pointers to Node objects representing the edges to be included in the segment.
- *              Each pair represents an edge between two nodes.
+ * @param edges A vector of pairs of component node indices representing the edges to be included in the
+ *              segment. It is relabeled in place with the segment node indices.
  * @return A pointer to the newly created Segment object.
  */
-const Segment* SegmentsHandler::buildSegment(std::vector<const Node*>& nodes,
-std::vector<std::pair<const Node*, const Node*>>& edges) {
-    Segment* segment = new Segment(nodes.size()+originalCycle_m->size(), originalComponent_m, originalCycle_m);
+const Segment* SegmentsHandler::buildSegment(std::vector<const Node*>& nodes, std::vector<std::pair<int, int>>& edges) {
+    const int cycleSize = originalCycle_m->size();
     // first nodes MUST be the same of the cycle in the SAME ORDER
     int oldToNewLabel[originalComponent_m->size()];
-    // adding cycle nodes (which means setting up the pointers)
-    for (int i = 0; i < originalCycle_m->size(); ++i) {
+    for (int i = 0; i < cycleSize; ++i)
+        oldToNewLabel[originalCycle_m->getNode(i)->getIndex()] = i;
+    for (int i = 0; i < nodes.size(); ++i) // remember that nodes does not include cycle nodes
+        oldToNewLabel[nodes[i]->getIndex()] = i+cycleSize;
+    // relabeling edges and adding cycle edges
+    const int numberOfSegmentEdges = edges.size();
+    for (std::pair<int, int>& edge : edges) {
+        edge.first = oldToNewLabel[edge.first];
+        edge.second = oldToNewLabel[edge.second];
+    }
+    for (int i = 0; i < cycleSize-1; ++i)
+        edges.push_back(std::make_pair(i, i+1));
+    edges.push_back(std::make_pair(0, cycleSize-1));
+    Segment* segment = new Segment(nodes.size()+cycleSize, originalComponent_m, originalCycle_m, edges, resource_m);
+    // setting up the pointers of the cycle nodes
+    for (int i = 0; i < cycleSize; ++i) {
         const Node* cycleNode = originalCycle_m->getNode(i);
-        oldToNewLabel[cycleNode->getIndex()] = i;
         const Node* newNode = segment->getNode(i);
         segment->setComponentNode(newNode, cycleNode);
         const Node* originalNode = originalComponent_m->getOriginalNode(cycleNode);
         segment->setOriginalNode(newNode, originalNode);
     }
-    // adding the other nodes of the segment (setting up the pointers)
-    for (int i = 0; i < nodes.size(); ++i) { // remember that nodes does not include cycle nodes
+    // setting up the pointers of the other nodes of the segment
+    for (int i = 0; i < nodes.size(); ++i) {
         const Node* oldNode = nodes[i];
-        int index = i+originalCycle_m->size();
-        oldToNewLabel[oldNode->getIndex()] = index;
-        const Node* newNode = segment->getNode(index);
+        const Node* newNode = segment->getNode(i+cycleSize);
         segment->setComponentNode(newNode, oldNode);
         const Node* originalNode = originalComponent_m->getOriginalNode(oldNode);
         segment->setOriginalNode(newNode, originalNode);
     }
-    // adding edges
-    for (std::pair<const Node*, const Node*>& edge : edges) {
-        int fromIndex = oldToNewLabel[edge.first->getIndex()];
-        int toIndex = oldToNewLabel[edge.second->getIndex()];
-        segment->addEdge(fromIndex, toIndex);
-        // adding attachment
-        if (originalCycle_m->hasNode(edge.first))
-            segment->addAttachment(segment->getNode(fromIndex));
-        if (originalCycle_m->hasNode(edge.second))
-            segment->addAttachment(segment->getNode(toIndex));
+    // adding attachments
+    for (int i = 0; i < numberOfSegmentEdges; ++i) {
+        if (edges[i].first < cycleSize)
+            segment->addAttachment(segment->getNode(edges[i].first));
+        if (edges[i].second < cycleSize)
+            segment->addAttachment(segment->getNode(edges[i].second));
     }
-    // adding cycle edges
-    for (int i = 0; i < originalCycle_m->size()-1; ++i)
-        segment->addEdge(i, i+1);
-    segment->addEdge(0, originalCycle_m->size()-1);
     return segment;
 }
 
 /**
- * @brief Constructs a new chord segment based on the provided attachment nodes.
+ * @brief Retrieves a constant pointer to a Segment object at the specified index.
+ * 
+ * @param index The index of the segment to retrieve.
+ * @return const Segment* A constant pointer to the Segment object at the specified index.
+ */
+const Segment* SegmentsHandler::getSegment(const int index) const {
+    assert(!isChord(index));
+    return segments_m[index].get();
+}
+
+/**
+ * @brief Checks if the segment at the given index is a chord.
  *
- * The chord is constructed by copying the nodes from the original cycle and maintaining the same order.
+ * @param index The index of the segment.
+ * @return true if the segment is a chord, stored as a Chord record, false otherwise.
+ */
+bool SegmentsHandler::isChord(const int index) const {
+    return index >= segments_m.size();
+}
+
+/**
+ * @brief Retrieves the chord at the specified index.
  *
- * @param attachment1 The first attachment node in the original cycle.
- * @param attachment2 The second attachment node in the original cycle.
- * @return A pointer to the newly created Segment object representing the chord.
+ * @param index The index of the segment, which must be a chord.
+ * @return const Chord& The chord, with the positions of its endpoints in the cycle.
  */
-const Segment* SegmentsHandler::buildChord(const Node* attachment1, const Node* attachment2) {
-    Segment* chord = new Segment(originalCycle_m->size(), originalComponent_m, originalCycle_m);
-    // assigning labels
-    // first nodes MUST be the same of the cycle in the SAME ORDER
-    for (int i = 0; i < originalCycle_m->size(); ++i) {
-        const Node* oldNode = originalCycle_m->getNode(i);
-        const Node* newNode = chord->getNode(i);
-        chord->setComponentNode(newNode, oldNode);
-        const Node* originalNode = originalComponent_m->getOriginalNode(oldNode);
-        chord->setOriginalNode(newNode, originalNode);
+const Chord& SegmentsHandler::getChord(const int index) const {
+    assert(isChord(index));
+    return chords_m[index-segments_m.size()];
+}
+
+/**
+ * @brief Returns the number of attachments of the segment (or chord) at the given index.
+ *
+ * @param index The index of the segment.
+ * @return int The number of attachments, 2 for chords.
+ */
+int SegmentsHandler::getNumberOfAttachments(const int index) const {
+    if (isChord(index)) return 2;
+    return segments_m[index]->getAttachments().size();
+}
+
+/**
+ * @brief Retrieves the position in the cycle of an attachment of a segment (or chord).
+ *
+ * The attachments of a segment come in the order of getAttachments, the node index of
+ * an attachment in the segment being its position in the cycle.
+ *
+ * @param index The index of the segment.
+ * @param attachmentIndex The index of the attachment, less than getNumberOfAttachments(index).
+ * @return int The position in the cycle of the attachment.
+ */
+int SegmentsHandler::getAttachmentPosition(const int index, const int attachmentIndex) const {
+    if (isChord(index)) {
+        const Chord& chord = getChord(index);
+        return attachmentIndex == 0 ? chord.from : chord.to;
     }
-    // adding cycle edges
-    for (int i = 0; i < originalCycle_m->size()-1; ++i)
-        chord->addEdge(i, i+1);
-    chord->addEdge(0, originalCycle_m->size()-1);
-    // adding chord edge
-    std::optional<int> fromIndex = originalCycle_m->getPositionOfNode(attachment1);
-    std::optional<int> toIndex = originalCycle_m->getPositionOfNode(attachment2);
-    assert(fromIndex);
-    assert(toIndex);
-    chord->addEdge(fromIndex.value(), toIndex.value());
-    chord->addAttachment(chord->getNode(fromIndex.value()));
-    chord->addAttachment(chord->getNode(toIndex.value()));
-    return chord;
+    return segments_m[index]->getAttachments()[attachmentIndex]->getIndex();
 }
 
 /**
- * @brief Retrieves a constant pointer to a Segment object at the specified index.
- * 
- * @param index The index of the segment to retrieve.
- * @return const Segment* A constant pointer to the Segment object at the specified index.
+ * @brief Indexes the segments (and chords) attached at each position of the cycle.
+ *
+ * The attachments are bucketed by position with a counting sort, in O(|C| + A) time
+ * for A attachments in total; each bucket lists its segments by increasing index.
  */
-const Segment* SegmentsHandler::getSegment(const int index) const {
-    return segments_m[index].get();
+void SegmentsHandler::buildAttachmentsIndex() {
+    const int cycleSize = originalCycle_m->size();
+    attachedOffsets_m.assign(cycleSize+1, 0);
+    for (int i = 0; i < size(); ++i)
+        for (int k = 0; k < getNumberOfAttachments(i); ++k)
+            ++attachedOffsets_m[getAttachmentPosition(i, k)+1];
+    for (int position = 0; position < cycleSize; ++position)
+        attachedOffsets_m[position+1] += attachedOffsets_m[position];
+    attachedSegments_m.resize(attachedOffsets_m[cycleSize]);
+    std::vector<int> next(attachedOffsets_m.begin(), attachedOffsets_m.end()-1);
+    for (int i = 0; i < size(); ++i)
+        for (int k = 0; k < getNumberOfAttachments(i); ++k)
+            attachedSegments_m[next[getAttachmentPosition(i, k)]++] = i;
+}
+
+/**
+ * @brief Returns the number of segments (chords included) attached at a cycle node.
+ *
+ * @param cyclePosition The position of the node in the cycle.
+ * @return int The number of segments having the node as attachment.
+ */
+int SegmentsHandler::getNumberOfSegmentsAttachedAt(const int cyclePosition) const {
+    return attachedOffsets_m[cyclePosition+1]-attachedOffsets_m[cyclePosition];
+}
+
+/**
+ * @brief Retrieves one of the segments (or chords) attached at a cycle node.
+ *
+ * @param cyclePosition The position of the node in the cycle.
+ * @param k Which of the attached segments, less than getNumberOfSegmentsAttachedAt(cyclePosition);
+ *        they come by increasing index.
+ * @return int The index of the segment.
+ */
+int SegmentsHandler::getSegmentAttachedAt(const int cyclePosition, const int k) const {
+    assert(k < getNumberOfSegmentsAttachedAt(cyclePosition));
+    return attachedSegments_m[attachedOffsets_m[cyclePosition]+k];
 }
 
 /**
@@ -361,6 +493,12 @@ const Segment* SegmentsHandler::getSegment(const int index) const {
 void SegmentsHandler::print() const {
     for (int i = 0; i < size(); ++i) {
         std::cout << "segment [" << i << "]\n";
+        if (isChord(i)) {
+            const Chord& chord = getChord(i);
+            std::cout << "chord: " << originalComponent_m->getOriginalNode(originalCycle_m->getNode(chord.from))->getIndex()
+                << " " << originalComponent_m->getOriginalNode(originalCycle_m->getNode(chord.to))->getIndex() << "\n";
+            continue;
+        }
         const Segment* segment = getSegment(i);
         segment->print();
     }
@@ -369,8 +507,8 @@ void SegmentsHandler::print() const {
 /**
  * @brief Returns the number of segments managed by the SegmentsHandler.
  * 
- * @return int The number of segments.
+ * @return int The number of segments, chords included.
  */
 int SegmentsHandler::size() const {
-    return segments_m.size();
+    return segments_m.size()+chords_m.size();
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <utility>
 #include <list>
 #include <memory>
+#include <memory_resource>
 
 #include "cycle.hpp"
 #include "../basic/graph.hpp"
@@ -15,20 +16,30 @@
  * @brief Represents a segment of a cycle.
  * 
  * A segment is a connected subgraph of a graph obtained by removing the cycle from the graph.
+ * Its nodes are the cycle nodes, in the same order, followed by the nodes of the segment.
+ * The segment is built already compacted, from its list of edges.
+ * A segment is a copy, not a view over the storage of its component: the recursion, its
+ * cycles and the merge of the embeddings rely on the cycle nodes being the first nodes
+ * of the segment, so the whole cycle is stored again in each segment, and a component
+ * with k segments and a cycle of length L stores O(k L) nodes for them. The segments
+ * live in the arena of the call embedding their component, so only the levels on the
+ * current recursion path are held at once.
  * 
  * @see SubGraph
  */
 class Segment : public SubGraph {
 private:
-    std::vector<const Node*> attachmentNodes_m{};
-    std::vector<bool> isNodeAnAttachment_m{};
+    std::pmr::vector<const Node*> attachmentNodes_m;
+    std::pmr::vector<bool> isNodeAnAttachment_m;
     const SubGraph* originalComponent_m;
     const Cycle* originalCycle_m;
     ArrayPointers<const Node> componentNodesPointers_m;
 public:
-    Segment(const int numberOfNodes, const SubGraph* originalComponent, const Cycle* cycle);
+    Segment(const int numberOfNodes, const SubGraph* originalComponent, const Cycle* cycle,
+        const std::vector<std::pair<int, int>>& edges,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     bool isPath() const;
-    const std::vector<const Node*>& getAttachments() const;
+    const std::pmr::vector<const Node*>& getAttachments() const;
     void addAttachment(const Node* attachment);
     bool isNodeAnAttachment(const Node* node) const;
     std::list<const Node*> computePathBetweenAttachments(const Node* start, const Node* end) const;
@@ -38,30 +49,66 @@ public:
     void setComponentNode(const Node* node, const Node* componentNode);
 };
 
+/**
+ * @struct Chord
+ * @brief A chord of a cycle: an edge between two nodes of the cycle that are not consecutive.
+ *
+ * The endpoints are positions in the cycle, from being the endpoint with the higher index
+ * in the component.
+ */
+struct Chord {
+    int from;
+    int to;
+};
+
 /**
  * @class SegmentsHandler
  * @brief Manages segments of a cycle.
  * 
  * This class is responsible for finding and storing segments of a cycle.
+ * The storage of the segments is allocated from the given memory resource.
+ * Chords are segments too, but they are stored as Chord records, with no subgraph:
+ * the indices of the handler list the segments first and then the chords, and the
+ * attachments of both are available as positions in the cycle.
+ * When a cycle with a single segment is changed with a path of that segment,
+ * the segments of the new cycle are found without scanning the whole cycle for
+ * chords, since only the chords touching the path can be new.
+ * Once the segments are found, the ones attached at each position of the cycle are
+ * indexed, so they can be listed without testing every segment.
  * 
  * @see Segment
  */
 class SegmentsHandler {
 private:
     std::vector<std::unique_ptr<const Segment>> segments_m{};
+    std::vector<Chord> chords_m{};
     const Cycle* originalCycle_m;
     const SubGraph* originalComponent_m;
-    const Segment* buildSegment(std::vector<const Node*>& nodes,
-        std::vector<std::pair<const Node*, const Node*>>& edges);
-    const Segment* buildChord(const Node* attachment1, const Node* attachment2);
+    std::pmr::memory_resource* resource_m;
+    // segments attached at each position of the cycle, by increasing index
+    std::vector<int> attachedOffsets_m{};
+    std::vector<int> attachedSegments_m{};
+    const Segment* buildSegment(std::vector<const Node*>& nodes, std::vector<std::pair<int, int>>& edges);
     void dfsFindSegments(const Node* node, bool isNodeVisited[],
         std::vector<const Node*>& nodesInSegment,
-        std::vector<std::pair<const Node*, const Node*>>& edgesInSegment);
+        std::vector<std::pair<int, int>>& edgesInSegment);
     void findSegments();
     void findChords();
+    void findChordsOfNode(const Node* node);
+    void findChordsAroundPath(const std::list<const Node*>& path);
+    void buildAttachmentsIndex();
 public:
-    SegmentsHandler(const SubGraph* component, const Cycle* cycle);
+    SegmentsHandler(const SubGraph* component, const Cycle* cycle,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    SegmentsHandler(const SubGraph* component, const Cycle* cycle, const std::list<const Node*>& changedPath,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     const Segment* getSegment(const int index) const;
+    bool isChord(const int index) const;
+    const Chord& getChord(const int index) const;
+    int getNumberOfAttachments(const int index) const;
+    int getAttachmentPosition(const int index, const int attachmentIndex) const;
+    int getNumberOfSegmentsAttachedAt(const int cyclePosition) const;
+    int getSegmentAttachedAt(const int cyclePosition, const int k) const;
     int size() const;
     void print() const;
 };
@@ -0,0 +1,814 @@
+#include "spqrTree.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+/**
+ * @struct DecompositionEdge
+ * @brief An edge handled while splitting a block: a real edge of the block or one
+ * of the two twin virtual edges added at each split.
+ */
+struct DecompositionEdge {
+    int from;
+    int to;
+    int realIndex; // index of the edge in the block, -1 for virtual edges
+    int twin; // index of the twin virtual edge, -1 for real edges
+};
+
+/**
+ * @struct SplitComponent
+ * @brief A split component: a bond, a cycle or a triconnected graph.
+ */
+struct SplitComponent {
+    SPQRNodeType type;
+    std::vector<int> edges;
+};
+
+/**
+ * @struct Piece
+ * @brief A biconnected part of the block still to be split.
+ *
+ * The vertices lower than firstVertexToScan are known not to be in any separation
+ * pair of the piece, since a separation pair of a split component is also a
+ * separation pair of the piece it has been split from.
+ */
+struct Piece {
+    std::vector<int> edges;
+    int firstVertexToScan;
+};
+
+/**
+ * @class SplitComponentsBuilder
+ * @brief Splits a biconnected multigraph into its split components and merges the
+ * adjacent bonds and the adjacent cycles, giving the triconnected components.
+ */
+class SplitComponentsBuilder {
+private:
+    std::vector<DecompositionEdge> edges_m{};
+    std::vector<SplitComponent> components_m{};
+    std::vector<int> localIndex_m;
+    // local adjacency of the piece being split, in compressed form
+    std::vector<int> offsets_m{};
+    std::vector<std::pair<int, int>> adjacency_m{}; // (neighbor, edge) pairs
+    std::vector<int> discoveryTime_m{};
+    std::vector<int> lowPoint_m{};
+    std::vector<int> lastVisitor_m{};
+    std::vector<int> edgesToNeighbor_m{};
+    std::vector<int> bondOfNeighbor_m{};
+    int addVirtualPair(const int from, const int to);
+    void buildAdjacency(const std::vector<int>& edges, const int numberOfVertices);
+    void splitPiece(Piece& piece, const std::vector<int>& vertices, std::vector<Piece>& pieces);
+    int findCutVertex(const int numberOfVertices, const int removedVertex);
+public:
+    SplitComponentsBuilder(const int numberOfVertices);
+    void addRealEdge(const int from, const int to, const int realIndex);
+    void split();
+    void mergeComponents(std::vector<int>& mergedInto, std::vector<bool>& isEdgeRemoved);
+    const std::vector<DecompositionEdge>& getEdges() const;
+    const std::vector<SplitComponent>& getComponents() const;
+};
+
+SplitComponentsBuilder::SplitComponentsBuilder(const int numberOfVertices)
+: localIndex_m(numberOfVertices, -1) {}
+
+void SplitComponentsBuilder::addRealEdge(const int from, const int to, const int realIndex) {
+    edges_m.push_back(DecompositionEdge{from, to, realIndex, -1});
+}
+
+// adds a pair of twin virtual edges between from and to, returning the index of the first one
+int SplitComponentsBuilder::addVirtualPair(const int from, const int to) {
+    const int first = edges_m.size();
+    edges_m.push_back(DecompositionEdge{from, to, -1, first+1});
+    edges_m.push_back(DecompositionEdge{from, to, -1, first});
+    return first;
+}
+
+const std::vector<DecompositionEdge>& SplitComponentsBuilder::getEdges() const {
+    return edges_m;
+}
+
+const std::vector<SplitComponent>& SplitComponentsBuilder::getComponents() const {
+    return components_m;
+}
+
+/**
+ * @brief Splits all the real edges added so far into split components.
+ *
+ * The pieces still to be split are kept in an explicit stack, so deep decompositions
+ * (e.g. long ladders) do not exhaust the call stack.
+ */
+void SplitComponentsBuilder::split() {
+    std::vector<Piece> pieces{};
+    Piece whole{std::vector<int>(edges_m.size()), 0};
+    for (int i = 0; i < edges_m.size(); ++i)
+        whole.edges[i] = i;
+    pieces.push_back(std::move(whole));
+    std::vector<int> vertices{};
+    while (!pieces.empty()) {
+        Piece piece = std::move(pieces.back());
+        pieces.pop_back();
+        vertices.clear();
+        for (const int edge : piece.edges)
+            for (const int vertex : {edges_m[edge].from, edges_m[edge].to})
+                if (localIndex_m[vertex] == -1) {
+                    localIndex_m[vertex] = 0;
+                    vertices.push_back(vertex);
+                }
+        std::sort(vertices.begin(), vertices.end());
+        for (int i = 0; i < vertices.size(); ++i)
+            localIndex_m[vertices[i]] = i;
+        splitPiece(piece, vertices, pieces);
+        for (const int vertex : vertices)
+            localIndex_m[vertex] = -1;
+    }
+}
+
+/**
+ * @brief Splits a piece once, or records it as a split component if it cannot be split.
+ *
+ * Bundles of parallel edges are split off first as bonds, found in linear time by
+ * counting the edges from each vertex to each of its higher neighbors. A simple piece where all the
+ * vertices have degree 2 is a cycle. Otherwise the piece is split at its first
+ * separation pair {a, b}: the edges of one connected component of the piece without a
+ * and b go on one side, all the other edges on the other side, and each side gets one
+ * of two new twin virtual edges (a, b). A piece with no separation pair is triconnected.
+ *
+ * @param piece The piece to be split.
+ * @param vertices The vertices of the piece, in increasing order (localIndex_m maps them to their positions).
+ * @param pieces The stack of pieces still to be split, where the new pieces are pushed.
+ */
+void SplitComponentsBuilder::splitPiece(Piece& piece, const std::vector<int>& vertices, std::vector<Piece>& pieces) {
+    if (vertices.size() == 2) {
+        components_m.push_back(SplitComponent{P_NODE, std::move(piece.edges)});
+        return;
+    }
+    const int numberOfVertices = vertices.size();
+    buildAdjacency(piece.edges, numberOfVertices);
+    // splitting off the bundles of parallel edges, counting the edges from each vertex to its neighbors
+    lastVisitor_m.assign(numberOfVertices, -1);
+    edgesToNeighbor_m.resize(numberOfVertices);
+    bondOfNeighbor_m.resize(numberOfVertices);
+    std::vector<int> simpleEdges{};
+    bool hasBundles = false;
+    for (int u = 0; u < numberOfVertices; ++u) {
+        for (int i = offsets_m[u]; i < offsets_m[u+1]; ++i) {
+            const int v = adjacency_m[i].first;
+            if (v < u) continue;
+            if (lastVisitor_m[v] != u) {
+                lastVisitor_m[v] = u;
+                edgesToNeighbor_m[v] = 0;
+                bondOfNeighbor_m[v] = -1;
+            }
+            ++edgesToNeighbor_m[v];
+        }
+        for (int i = offsets_m[u]; i < offsets_m[u+1]; ++i) {
+            const int v = adjacency_m[i].first;
+            if (v < u) continue;
+            if (edgesToNeighbor_m[v] == 1) {
+                simpleEdges.push_back(adjacency_m[i].second);
+                continue;
+            }
+            hasBundles = true;
+            if (bondOfNeighbor_m[v] == -1) {
+                const int virtualEdge = addVirtualPair(vertices[u], vertices[v]);
+                bondOfNeighbor_m[v] = components_m.size();
+                components_m.push_back(SplitComponent{P_NODE, std::vector<int>{virtualEdge}});
+                simpleEdges.push_back(virtualEdge+1);
+            }
+            components_m[bondOfNeighbor_m[v]].edges.push_back(adjacency_m[i].second);
+        }
+    }
+    if (hasBundles) {
+        piece.edges = std::move(simpleEdges);
+        buildAdjacency(piece.edges, numberOfVertices);
+    }
+    bool isCycle = true;
+    for (int i = 0; i < numberOfVertices; ++i)
+        if (offsets_m[i+1] - offsets_m[i] != 2) isCycle = false;
+    if (isCycle) {
+        components_m.push_back(SplitComponent{S_NODE, std::move(piece.edges)});
+        return;
+    }
+    // looking for a separation pair {a, b}, with b a cut vertex of the piece without a
+    for (int a = 0; a < numberOfVertices; ++a) {
+        if (vertices[a] < piece.firstVertexToScan) continue;
+        const int b = findCutVertex(numberOfVertices, a);
+        if (b == -1) continue;
+        // the vertices of one connected component of the piece without a and b
+        std::vector<bool> isInComponent(numberOfVertices, false);
+        int start = 0;
+        while (start == a || start == b) ++start;
+        std::vector<int> stack{start};
+        isInComponent[start] = true;
+        while (!stack.empty()) {
+            const int vertex = stack.back();
+            stack.pop_back();
+            for (int i = offsets_m[vertex]; i < offsets_m[vertex+1]; ++i) {
+                const int neighbor = adjacency_m[i].first;
+                if (neighbor == a || neighbor == b || isInComponent[neighbor]) continue;
+                isInComponent[neighbor] = true;
+                stack.push_back(neighbor);
+            }
+        }
+        const int virtualEdge = addVirtualPair(vertices[a], vertices[b]);
+        Piece side1{std::vector<int>{}, vertices[a]};
+        Piece side2{std::vector<int>{}, vertices[a]};
+        for (const int edge : piece.edges) {
+            const bool isInSide1 = isInComponent[localIndex_m[edges_m[edge].from]] ||
+                isInComponent[localIndex_m[edges_m[edge].to]];
+            (isInSide1 ? side1 : side2).edges.push_back(edge);
+        }
+        side1.edges.push_back(virtualEdge);
+        side2.edges.push_back(virtualEdge+1);
+        pieces.push_back(std::move(side2));
+        pieces.push_back(std::move(side1));
+        return;
+    }
+    components_m.push_back(SplitComponent{R_NODE, std::move(piece.edges)});
+}
+
+/**
+ * @brief Builds the local adjacency of a piece, as (neighbor, edge) pairs in compressed form.
+ *
+ * @param edges The edges of the piece.
+ * @param numberOfVertices The number of vertices of the piece (localIndex_m maps them to 0 ... numberOfVertices-1).
+ */
+void SplitComponentsBuilder::buildAdjacency(const std::vector<int>& edges, const int numberOfVertices) {
+    offsets_m.assign(numberOfVertices+1, 0);
+    for (const int edge : edges) {
+        ++offsets_m[localIndex_m[edges_m[edge].from]+1];
+        ++offsets_m[localIndex_m[edges_m[edge].to]+1];
+    }
+    for (int i = 0; i < numberOfVertices; ++i)
+        offsets_m[i+1] += offsets_m[i];
+    adjacency_m.resize(offsets_m[numberOfVertices]);
+    std::vector<int> nextPosition(offsets_m.begin(), offsets_m.end()-1);
+    for (const int edge : edges) {
+        const int from = localIndex_m[edges_m[edge].from];
+        const int to = localIndex_m[edges_m[edge].to];
+        adjacency_m[nextPosition[from]++] = std::make_pair(to, edge);
+        adjacency_m[nextPosition[to]++] = std::make_pair(from, edge);
+    }
+}
+
+/**
+ * @brief Finds a cut vertex of the piece being split, after removing one of its vertices.
+ *
+ * Iterative depth-first search computing discovery times and low points on the local
+ * adjacency of the piece, skipping the removed vertex.
+ *
+ * @param numberOfVertices The number of vertices of the piece.
+ * @param removedVertex The local index of the vertex removed from the piece.
+ * @return int The local index of a cut vertex, or -1 if the piece without removedVertex is biconnected.
+ */
+int SplitComponentsBuilder::findCutVertex(const int numberOfVertices, const int removedVertex) {
+    discoveryTime_m.assign(numberOfVertices, -1);
+    lowPoint_m.assign(numberOfVertices, -1);
+    const int root = removedVertex == 0 ? 1 : 0;
+    int nextTime = 0;
+    int rootChildren = 0;
+    // frames of the DFS path: (vertex, edge to the parent, next position in the adjacency)
+    std::vector<std::tuple<int, int, int>> frames{};
+    discoveryTime_m[root] = nextTime;
+    lowPoint_m[root] = nextTime;
+    ++nextTime;
+    frames.push_back(std::make_tuple(root, -1, offsets_m[root]));
+    while (!frames.empty()) {
+        const int vertex = std::get<0>(frames.back());
+        const int parentEdge = std::get<1>(frames.back());
+        const int position = std::get<2>(frames.back());
+        if (position < offsets_m[vertex+1]) {
+            ++std::get<2>(frames.back());
+            const int neighbor = adjacency_m[position].first;
+            if (neighbor == removedVertex || adjacency_m[position].second == parentEdge) continue;
+            if (discoveryTime_m[neighbor] == -1) {
+                if (vertex == root) ++rootChildren;
+                discoveryTime_m[neighbor] = nextTime;
+                lowPoint_m[neighbor] = nextTime;
+                ++nextTime;
+                frames.push_back(std::make_tuple(neighbor, adjacency_m[position].second, offsets_m[neighbor]));
+            }
+            else if (discoveryTime_m[neighbor] < lowPoint_m[vertex])
+                lowPoint_m[vertex] = discoveryTime_m[neighbor];
+            continue;
+        }
+        frames.pop_back();
+        if (frames.empty()) break;
+        const int parent = std::get<0>(frames.back());
+        if (lowPoint_m[vertex] < lowPoint_m[parent])
+            lowPoint_m[parent] = lowPoint_m[vertex];
+        if (parent != root && lowPoint_m[vertex] >= discoveryTime_m[parent])
+            return parent;
+    }
+    return rootChildren >= 2 ? root : -1;
+}
+
+/**
+ * @brief Merges the split components sharing a pair of twin virtual edges when both are
+ * bonds or both are cycles.
+ *
+ * @param mergedInto Output vector, for each split component the component it has been merged
+ *        into (itself if it has not been merged).
+ * @param isEdgeRemoved Output vector, true for the virtual edges removed by the merges.
+ */
+void SplitComponentsBuilder::mergeComponents(std::vector<int>& mergedInto, std::vector<bool>& isEdgeRemoved) {
+    std::vector<int> componentOfEdge(edges_m.size(), -1);
+    isEdgeRemoved.assign(edges_m.size(), false);
+    for (int i = 0; i < components_m.size(); ++i)
+        for (const int edge : components_m[i].edges)
+            componentOfEdge[edge] = i;
+    mergedInto.resize(components_m.size());
+    for (int i = 0; i < components_m.size(); ++i)
+        mergedInto[i] = i;
+    auto find = [&mergedInto](int component) {
+        while (mergedInto[component] != component) {
+            mergedInto[component] = mergedInto[mergedInto[component]];
+            component = mergedInto[component];
+        }
+        return component;
+    };
+    for (int edge = 0; edge < edges_m.size(); ++edge) {
+        const int twin = edges_m[edge].twin;
+        if (twin == -1 || twin < edge) continue;
+        const int component1 = find(componentOfEdge[edge]);
+        const int component2 = find(componentOfEdge[twin]);
+        const SPQRNodeType type = components_m[component1].type;
+        if (type == R_NODE || type != components_m[component2].type) continue;
+        mergedInto[component2] = component1;
+        isEdgeRemoved[edge] = true;
+        isEdgeRemoved[twin] = true;
+    }
+    for (int i = 0; i < components_m.size(); ++i)
+        mergedInto[i] = find(i);
+}
+
+/**
+ * @brief Constructs the SPQR-tree of a biconnected component.
+ *
+ * @param block A pointer to the biconnected component (a simple biconnected graph,
+ *        or a single edge or node), which must outlive the tree.
+ */
+SPQRTree::SPQRTree(const SubGraph* block) : block_m(block) {
+    buildNodes();
+    computeParents();
+    for (SPQRNode& node : nodes_m)
+        if (node.type == R_NODE)
+            embedRigidNode(node);
+}
+
+/**
+ * @brief Numbers the edges of the block, splits the block and builds the nodes of the tree.
+ */
+void SPQRTree::buildNodes() {
+    const int numberOfNodes = block_m->size();
+    edgesOffsets_m.assign(numberOfNodes+1, 0);
+    for (int i = 0; i < numberOfNodes; ++i)
+        edgesOffsets_m[i+1] = edgesOffsets_m[i] + block_m->getNode(i)->getDegree();
+    // the two positions of each edge in the adjacency lists are found by sorting them by endpoints
+    std::vector<std::tuple<int, int, int>> positions{};
+    positions.reserve(edgesOffsets_m[numberOfNodes]);
+    for (int i = 0; i < numberOfNodes; ++i) {
+        const NeighborsRange neighbors = block_m->getNode(i)->getNeighbors();
+        for (int j = 0; j < neighbors.size(); ++j) {
+            const int neighbor = neighbors.getIndex(j);
+            positions.push_back(std::make_tuple(std::min(i, neighbor), std::max(i, neighbor), edgesOffsets_m[i]+j));
+        }
+    }
+    std::sort(positions.begin(), positions.end());
+    edgeOfPosition_m.assign(positions.size(), -1);
+    SplitComponentsBuilder builder(numberOfNodes);
+    for (int i = 0; i+1 < positions.size(); i += 2) {
+        assert(std::get<0>(positions[i]) == std::get<0>(positions[i+1]));
+        assert(std::get<1>(positions[i]) == std::get<1>(positions[i+1]));
+        const int edge = i/2;
+        edgeOfPosition_m[std::get<2>(positions[i])] = edge;
+        edgeOfPosition_m[std::get<2>(positions[i+1])] = edge;
+        builder.addRealEdge(std::get<0>(positions[i]), std::get<1>(positions[i]), edge);
+    }
+    const int numberOfEdges = positions.size()/2;
+    nodeOfEdge_m.assign(numberOfEdges, -1);
+    skeletonEdgeOfEdge_m.assign(numberOfEdges, -1);
+    if (numberOfEdges == 0) return;
+    builder.split();
+    std::vector<int> mergedInto{};
+    std::vector<bool> isEdgeRemoved{};
+    builder.mergeComponents(mergedInto, isEdgeRemoved);
+    const std::vector<DecompositionEdge>& edges = builder.getEdges();
+    const std::vector<SplitComponent>& components = builder.getComponents();
+    std::vector<int> nodeOfComponent(components.size(), -1);
+    for (int i = 0; i < components.size(); ++i)
+        if (mergedInto[i] == i) {
+            nodeOfComponent[i] = nodes_m.size();
+            nodes_m.push_back(SPQRNode{components[i].type});
+        }
+    // skeleton edges, and node and position in the skeleton of each decomposition edge
+    std::vector<int> nodeOfDecompositionEdge(edges.size(), -1);
+    std::vector<int> skeletonEdge(edges.size(), -1);
+    for (int i = 0; i < components.size(); ++i)
+        for (const int edge : components[i].edges) {
+            if (isEdgeRemoved[edge]) continue;
+            const int nodeIndex = nodeOfComponent[mergedInto[i]];
+            SPQRNode& node = nodes_m[nodeIndex];
+            nodeOfDecompositionEdge[edge] = nodeIndex;
+            skeletonEdge[edge] = node.edges.size();
+            node.edges.push_back(SkeletonEdge{edges[edge].from, edges[edge].to, -1, -1});
+            if (edges[edge].realIndex != -1) {
+                nodeOfEdge_m[edges[edge].realIndex] = nodeIndex;
+                skeletonEdgeOfEdge_m[edges[edge].realIndex] = node.edges.size()-1;
+            }
+        }
+    for (int edge = 0; edge < edges.size(); ++edge) {
+        if (edges[edge].twin == -1 || isEdgeRemoved[edge]) continue;
+        const int twin = edges[edge].twin;
+        SkeletonEdge& skeleton = nodes_m[nodeOfDecompositionEdge[edge]].edges[skeletonEdge[edge]];
+        skeleton.twinNode = nodeOfDecompositionEdge[twin];
+        skeleton.twinEdge = skeletonEdge[twin];
+    }
+    // vertices of each skeleton, with their incident edges
+    for (SPQRNode& node : nodes_m) {
+        for (const SkeletonEdge& edge : node.edges) {
+            node.vertices.push_back(edge.from);
+            node.vertices.push_back(edge.to);
+        }
+        std::sort(node.vertices.begin(), node.vertices.end());
+        node.vertices.erase(std::unique(node.vertices.begin(), node.vertices.end()), node.vertices.end());
+        node.incidentEdges.assign(node.vertices.size(), std::vector<int>{});
+        for (int i = 0; i < node.edges.size(); ++i) {
+            node.incidentEdges[getVertexPosition(node, node.edges[i].from)].push_back(i);
+            node.incidentEdges[getVertexPosition(node, node.edges[i].to)].push_back(i);
+        }
+    }
+}
+
+/**
+ * @brief Roots the tree at its first node and computes the parent and the depth of each node.
+ */
+void SPQRTree::computeParents() {
+    if (nodes_m.empty()) return;
+    std::vector<int> queue{0};
+    std::vector<bool> isVisited(nodes_m.size(), false);
+    isVisited[0] = true;
+    for (int queuePosition = 0; queuePosition < queue.size(); ++queuePosition) {
+        const int nodeIndex = queue[queuePosition];
+        for (const SkeletonEdge& edge : nodes_m[nodeIndex].edges) {
+            if (edge.twinNode == -1 || isVisited[edge.twinNode]) continue;
+            isVisited[edge.twinNode] = true;
+            SPQRNode& child = nodes_m[edge.twinNode];
+            child.parent = nodeIndex;
+            child.parentEdge = edge.twinEdge;
+            child.depth = nodes_m[nodeIndex].depth + 1;
+            queue.push_back(edge.twinNode);
+        }
+    }
+    assert(queue.size() == nodes_m.size());
+}
+
+/**
+ * @brief Embeds the skeleton of an R node and computes the faces on the two sides of each edge.
+ *
+ * The skeleton is triconnected, so its planar embedding is unique up to a mirroring.
+ * If the skeleton is not planar, neither is the block. The skeleton is embedded with the
+ * left-right algorithm.
+ *
+ * @param node The R node.
+ */
+void SPQRTree::embedRigidNode(SPQRNode& node) {
+    const int numberOfVertices = node.vertices.size();
+    Graph skeleton(numberOfVertices);
+    std::vector<std::pair<int, int>> localEdges{};
+    for (const SkeletonEdge& edge : node.edges) {
+        localEdges.push_back(std::make_pair(getVertexPosition(node, edge.from), getVertexPosition(node, edge.to)));
+        skeleton.addEdge(localEdges.back().first, localEdges.back().second);
+    }
+    skeleton.compact();
+    Embedder embedder(1, FIRST_FOUND_CYCLE, LEFT_RIGHT);
+    std::optional<const Embedding*> embedding = embedder.embedGraph(&skeleton);
+    if (!embedding.has_value()) {
+        isPlanar_m = false;
+        return;
+    }
+    std::unique_ptr<const Embedding> embeddingPtr(embedding.value());
+    // the rotation of each vertex, as indices of skeleton edges
+    for (int i = 0; i < numberOfVertices; ++i) {
+        std::vector<std::pair<int, int>> edgeOfNeighbor{};
+        for (const int edge : node.incidentEdges[i]) {
+            const int neighbor = localEdges[edge].first == i ? localEdges[edge].second : localEdges[edge].first;
+            edgeOfNeighbor.push_back(std::make_pair(neighbor, edge));
+        }
+        std::sort(edgeOfNeighbor.begin(), edgeOfNeighbor.end());
+        const NeighborsRange rotation = embeddingPtr->getNode(i)->getNeighbors();
+        assert(rotation.size() == edgeOfNeighbor.size());
+        for (int j = 0; j < rotation.size(); ++j) {
+            auto it = std::lower_bound(edgeOfNeighbor.begin(), edgeOfNeighbor.end(),
+                std::make_pair(rotation.getIndex(j), -1));
+            assert(it != edgeOfNeighbor.end() && it->first == rotation.getIndex(j));
+            node.incidentEdges[i][j] = it->second;
+        }
+    }
+    // faces, tracing the darts: dart 2*e goes from the first endpoint of e, dart 2*e+1 from the second one
+    std::vector<int> positionInRotation(2*node.edges.size());
+    for (int i = 0; i < numberOfVertices; ++i)
+        for (int j = 0; j < node.incidentEdges[i].size(); ++j) {
+            const int edge = node.incidentEdges[i][j];
+            positionInRotation[2*edge + (localEdges[edge].first == i ? 0 : 1)] = j;
+        }
+    std::vector<int> faceOfDart(2*node.edges.size(), -1);
+    int numberOfFaces = 0;
+    for (int dart = 0; dart < faceOfDart.size(); ++dart) {
+        if (faceOfDart[dart] != -1) continue;
+        int current = dart;
+        while (faceOfDart[current] == -1) {
+            faceOfDart[current] = numberOfFaces;
+            // the dart leaving the head of current, next to the reverse of current in the rotation
+            const int edge = current/2;
+            const int head = current%2 == 0 ? localEdges[edge].second : localEdges[edge].first;
+            const std::vector<int>& rotation = node.incidentEdges[head];
+            const int position = positionInRotation[current ^ 1];
+            const int nextEdge = rotation[(position+1) % rotation.size()];
+            current = 2*nextEdge + (localEdges[nextEdge].first == head ? 0 : 1);
+        }
+        ++numberOfFaces;
+    }
+    assert(numberOfFaces == node.edges.size() - numberOfVertices + 2);
+    node.edgeFaces.resize(node.edges.size());
+    for (int i = 0; i < node.edges.size(); ++i)
+        node.edgeFaces[i] = {faceOfDart[2*i], faceOfDart[2*i+1]};
+}
+
+/**
+ * @brief Gets the position of a vertex in the vertices of the skeleton of a node.
+ *
+ * @param node The node of the tree.
+ * @param vertex The block node index of the vertex.
+ * @return int The position of the vertex in node.vertices, which must contain it.
+ */
+int SPQRTree::getVertexPosition(const SPQRNode& node, const int vertex) const {
+    auto it = std::lower_bound(node.vertices.begin(), node.vertices.end(), vertex);
+    assert(it != node.vertices.end() && *it == vertex);
+    return it - node.vertices.begin();
+}
+
+/**
+ * @brief Gets the index of an edge of the block from its endpoints.
+ *
+ * @param fromIndex The block node index of one endpoint.
+ * @param toIndex The block node index of the other endpoint.
+ * @return int The index of the edge, or -1 if the block has no such edge.
+ */
+int SPQRTree::getEdgeIndex(const int fromIndex, const int toIndex) const {
+    const NeighborsRange neighbors = block_m->getNode(fromIndex)->getNeighbors();
+    for (int j = 0; j < neighbors.size(); ++j)
+        if (neighbors.getIndex(j) == toIndex)
+            return edgeOfPosition_m[edgesOffsets_m[fromIndex]+j];
+    return -1;
+}
+
+/**
+ * @brief Returns the block the tree has been built for.
+ *
+ * @return const SubGraph* A pointer to the block.
+ */
+const SubGraph* SPQRTree::getBlock() const {
+    return block_m;
+}
+
+/**
+ * @brief Returns the number of nodes of the tree.
+ *
+ * @return int The number of nodes (0 if the block has no edges).
+ */
+int SPQRTree::size() const {
+    return nodes_m.size();
+}
+
+/**
+ * @brief Retrieves a node of the tree by its index.
+ *
+ * @param index The index of the node.
+ * @return const SPQRNode& The node, with its skeleton.
+ */
+const SPQRNode& SPQRTree::getNode(const int index) const {
+    return nodes_m[index];
+}
+
+/**
+ * @brief Checks if the block is planar.
+ *
+ * @return true if the skeletons of all the R nodes are planar, false otherwise.
+ */
+bool SPQRTree::isPlanar() const {
+    return isPlanar_m;
+}
+
+/**
+ * @brief Counts the planar embeddings (rotation systems) of the block.
+ *
+ * Each R node can be mirrored and the k edges of each P node can be arranged in (k-1)!
+ * cyclic orders, independently of each other.
+ *
+ * @return uint64_t The number of planar embeddings, 0 if the block is not planar, or
+ *         UINT64_MAX if the number does not fit.
+ */
+uint64_t SPQRTree::numberOfEmbeddings() const {
+    if (!isPlanar_m) return 0;
+    uint64_t count = 1;
+    auto multiply = [&count](const uint64_t factor) {
+        count = count > UINT64_MAX/factor ? UINT64_MAX : count*factor;
+    };
+    for (const SPQRNode& node : nodes_m) {
+        if (node.type == R_NODE)
+            multiply(2);
+        else if (node.type == P_NODE)
+            for (int i = 2; i < node.edges.size(); ++i)
+                multiply(i);
+    }
+    return count;
+}
+
+/**
+ * @brief Checks if two edges of the skeleton of a node can be on the same face of an
+ * embedding of the skeleton.
+ *
+ * Always true for cycles and bonds; for R nodes the embedding is fixed up to a mirroring,
+ * so the two edges must share one of their faces.
+ */
+bool SPQRTree::canShareFaceInSkeleton(const SPQRNode& node, const int edge1, const int edge2) const {
+    if (node.type != R_NODE) return true;
+    const std::array<int, 2>& faces1 = node.edgeFaces[edge1];
+    const std::array<int, 2>& faces2 = node.edgeFaces[edge2];
+    return faces1[0] == faces2[0] || faces1[0] == faces2[1] || faces1[1] == faces2[0] || faces1[1] == faces2[1];
+}
+
+/**
+ * @brief Checks if two edges of the block can be on the same face of some planar embedding.
+ *
+ * The edges can share a face if and only if, in each node of the path of the tree between
+ * the nodes holding them, the two skeleton edges leading towards them can share a face.
+ * This costs O(length of the path), without embedding the block.
+ *
+ * @param from1 An endpoint of the first edge (block node index).
+ * @param to1 The other endpoint of the first edge.
+ * @param from2 An endpoint of the second edge.
+ * @param to2 The other endpoint of the second edge.
+ * @return true if an embedding with the two edges on the same face exists, false
+ *         otherwise (also if the block is not planar).
+ */
+bool SPQRTree::canShareFace(const int from1, const int to1, const int from2, const int to2) const {
+    if (!isPlanar_m) return false;
+    const int edge1 = getEdgeIndex(from1, to1);
+    const int edge2 = getEdgeIndex(from2, to2);
+    assert(edge1 != -1 && edge2 != -1);
+    if (edge1 == edge2) return true;
+    int node1 = nodeOfEdge_m[edge1];
+    int skeletonEdge1 = skeletonEdgeOfEdge_m[edge1];
+    int node2 = nodeOfEdge_m[edge2];
+    int skeletonEdge2 = skeletonEdgeOfEdge_m[edge2];
+    while (node1 != node2) {
+        const bool isFirstDeeper = nodes_m[node1].depth >= nodes_m[node2].depth;
+        int& nodeIndex = isFirstDeeper ? node1 : node2;
+        int& skeletonEdge = isFirstDeeper ? skeletonEdge1 : skeletonEdge2;
+        const SPQRNode& node = nodes_m[nodeIndex];
+        if (!canShareFaceInSkeleton(node, skeletonEdge, node.parentEdge))
+            return false;
+        skeletonEdge = node.edges[node.parentEdge].twinEdge;
+        nodeIndex = node.parent;
+    }
+    return canShareFaceInSkeleton(nodes_m[node1], skeletonEdge1, skeletonEdge2);
+}
+
+/**
+ * @brief Computes the rotation of a vertex in the skeleton of a node, for a given choice.
+ *
+ * @param nodeIndex The index of the node.
+ * @param vertexPosition The position of the vertex in the vertices of the node.
+ * @param isFlipped For R nodes, if the embedding of the skeleton is mirrored.
+ * @param order For P nodes, the order of the edges around the first pole (the second
+ *        pole gets the reverse order); if empty, the order of the skeleton edges.
+ * @return std::vector<int> The skeleton edges around the vertex, in order.
+ */
+std::vector<int> SPQRTree::computeRotation(const int nodeIndex, const int vertexPosition, const bool isFlipped,
+const std::vector<int>& order) const {
+    const SPQRNode& node = nodes_m[nodeIndex];
+    std::vector<int> rotation = node.incidentEdges[vertexPosition];
+    if (node.type == P_NODE && !order.empty())
+        rotation = order;
+    if ((node.type == R_NODE && isFlipped) || (node.type == P_NODE && vertexPosition == 1))
+        std::reverse(rotation.begin(), rotation.end());
+    return rotation;
+}
+
+/**
+ * @brief Builds the planar embedding of the block given by a choice for each node of the tree.
+ *
+ * The rotation of each vertex is built by walking its rotation in the skeleton of one of
+ * the nodes containing it, and replacing each virtual edge by the rotation of the vertex
+ * in the adjacent node (starting after the twin edge), recursively.
+ *
+ * @param isFlipped For each node, if the embedding of its skeleton is mirrored (used for R nodes).
+ * @param orders For each node, the order of its edges around the first pole (used for P nodes).
+ * @return const Embedding* The embedding of the block, or nullptr if the block is not planar.
+ */
+const Embedding* SPQRTree::computeEmbedding(const std::vector<bool>& isFlipped,
+const std::vector<std::vector<int>>& orders) const {
+    if (!isPlanar_m) return nullptr;
+    assert(isFlipped.size() == nodes_m.size() && orders.size() == nodes_m.size());
+    Embedding* embedding = new Embedding(block_m);
+    std::vector<int> firstNodeOfVertex(block_m->size(), -1);
+    for (int i = 0; i < nodes_m.size(); ++i)
+        for (const int vertex : nodes_m[i].vertices)
+            if (firstNodeOfVertex[vertex] == -1)
+                firstNodeOfVertex[vertex] = i;
+    struct RotationFrame {
+        int node;
+        std::vector<int> rotation;
+        int position;
+        int remaining;
+    };
+    std::vector<RotationFrame> frames{};
+    for (int vertex = 0; vertex < block_m->size(); ++vertex) {
+        const int firstNode = firstNodeOfVertex[vertex];
+        if (firstNode == -1) continue;
+        std::vector<int> rotation = computeRotation(firstNode, getVertexPosition(nodes_m[firstNode], vertex),
+            isFlipped[firstNode], orders[firstNode]);
+        const int rotationSize = rotation.size();
+        frames.push_back(RotationFrame{firstNode, std::move(rotation), 0, rotationSize});
+        while (!frames.empty()) {
+            RotationFrame& frame = frames.back();
+            if (frame.remaining == 0) {
+                frames.pop_back();
+                continue;
+            }
+            const int edgeIndex = frame.rotation[frame.position % frame.rotation.size()];
+            ++frame.position;
+            --frame.remaining;
+            const SkeletonEdge& edge = nodes_m[frame.node].edges[edgeIndex];
+            if (edge.twinNode == -1) {
+                embedding->addSingleEdge(vertex, edge.from == vertex ? edge.to : edge.from);
+                continue;
+            }
+            const int twinNode = edge.twinNode;
+            std::vector<int> twinRotation = computeRotation(twinNode, getVertexPosition(nodes_m[twinNode], vertex),
+                isFlipped[twinNode], orders[twinNode]);
+            const int twinPosition = std::find(twinRotation.begin(), twinRotation.end(), edge.twinEdge) - twinRotation.begin();
+            const int twinSize = twinRotation.size();
+            frames.push_back(RotationFrame{twinNode, std::move(twinRotation), twinPosition+1, twinSize-1});
+        }
+    }
+    return embedding;
+}
+
+/**
+ * @brief Constructs an enumerator starting from the first embedding of the block.
+ *
+ * @param tree A pointer to the SPQR-tree of the block, which must outlive the enumerator.
+ */
+SPQREmbeddingsEnumerator::SPQREmbeddingsEnumerator(const SPQRTree* tree)
+: tree_m(tree), isFlipped_m(tree->size(), false), orders_m(tree->size()), hasEmbedding_m(tree->isPlanar()) {
+    for (int i = 0; i < tree->size(); ++i)
+        if (tree->getNode(i).type == P_NODE)
+            for (int j = 0; j < tree->getNode(i).edges.size(); ++j)
+                orders_m[i].push_back(j);
+}
+
+/**
+ * @brief Checks if the enumerator is at an embedding.
+ *
+ * @return true if getEmbedding can be called, false once all the embeddings have been enumerated.
+ */
+bool SPQREmbeddingsEnumerator::hasEmbedding() const {
+    return hasEmbedding_m;
+}
+
+/**
+ * @brief Builds the current embedding.
+ *
+ * @return const Embedding* The current embedding of the block, owned by the caller.
+ */
+const Embedding* SPQREmbeddingsEnumerator::getEmbedding() const {
+    assert(hasEmbedding_m);
+    return tree_m->computeEmbedding(isFlipped_m, orders_m);
+}
+
+/**
+ * @brief Moves to the next embedding.
+ *
+ * The first node whose choice can still advance is advanced, and the choices of the
+ * nodes before it are reset, as in an odometer.
+ */
+void SPQREmbeddingsEnumerator::next() {
+    for (int i = 0; i < tree_m->size(); ++i) {
+        const SPQRNodeType type = tree_m->getNode(i).type;
+        if (type == R_NODE) {
+            isFlipped_m[i] = !isFlipped_m[i];
+            if (isFlipped_m[i]) return;
+        }
+        else if (type == P_NODE && orders_m[i].size() > 2)
+            if (std::next_permutation(orders_m[i].begin()+1, orders_m[i].end())) return;
+    }
+    hasEmbedding_m = false;
+}
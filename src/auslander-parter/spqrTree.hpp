@@ -0,0 +1,120 @@
+#ifndef MY_SPQR_TREE_H
+#define MY_SPQR_TREE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "../basic/graph.hpp"
+#include "embedder.hpp"
+
+enum SPQRNodeType : uint8_t {
+    S_NODE,
+    P_NODE,
+    R_NODE
+};
+
+/**
+ * @struct SkeletonEdge
+ * @brief An edge of the skeleton of a node of an SPQR-tree.
+ *
+ * The endpoints are node indices of the block. A real edge is an edge of the block,
+ * while a virtual edge stands for the part of the block on the other side of an edge
+ * of the tree, and is paired with its twin in the skeleton of the adjacent tree node.
+ */
+struct SkeletonEdge {
+    int from;
+    int to;
+    int twinNode; // -1 for real edges
+    int twinEdge; // -1 for real edges
+};
+
+/**
+ * @struct SPQRNode
+ * @brief A node of an SPQR-tree, with its skeleton.
+ *
+ * S nodes have a cycle as skeleton, P nodes a bundle of parallel edges between two poles
+ * and R nodes a triconnected graph. The edges incident to each vertex of the skeleton
+ * are listed in incidentEdges, in the order of the (unique up to a mirroring) planar
+ * embedding of the skeleton for R nodes.
+ */
+struct SPQRNode {
+    SPQRNodeType type;
+    std::vector<SkeletonEdge> edges{};
+    std::vector<int> vertices{}; // block node indices, in increasing order
+    std::vector<std::vector<int>> incidentEdges{}; // for each vertex, indices in edges
+    std::vector<std::array<int, 2>> edgeFaces{}; // R nodes only: the faces on the two sides of each edge
+    int parent = -1;
+    int parentEdge = -1; // index in edges of the virtual edge towards the parent
+    int depth = 0;
+};
+
+/**
+ * @class SPQRTree
+ * @brief The SPQR-tree (triconnected components) of a biconnected component of a graph.
+ *
+ * The block is split recursively at its separation pairs: bundles of parallel edges
+ * become P nodes, cycles S nodes and pieces with no separation pair left R nodes; then
+ * adjacent S nodes and adjacent P nodes are merged, which gives the unique SPQR-tree.
+ * Real edges are kept in the skeletons (there are no Q nodes). Separation pairs are
+ * found by removing each vertex and looking for cut vertices, skipping the vertices
+ * already known not to be in any separation pair of the piece, so the construction
+ * takes O(n*m) time.
+ *
+ * The skeleton of each R node is embedded once with the Embedder. After that, the
+ * planar embeddings of the block are counted and enumerated from the tree alone: an
+ * embedding is the choice of a mirroring for each R node and of a permutation of the
+ * edges of each P node. Whether two edges can be on the same face is answered by
+ * walking the path of the tree between them.
+ */
+class SPQRTree {
+private:
+    const SubGraph* block_m;
+    std::vector<SPQRNode> nodes_m{};
+    std::vector<int> edgesOffsets_m{};
+    std::vector<int> edgeOfPosition_m{};
+    std::vector<int> nodeOfEdge_m{};
+    std::vector<int> skeletonEdgeOfEdge_m{};
+    bool isPlanar_m = true;
+    void buildNodes();
+    void computeParents();
+    void embedRigidNode(SPQRNode& node);
+    int getEdgeIndex(const int fromIndex, const int toIndex) const;
+    int getVertexPosition(const SPQRNode& node, const int vertex) const;
+    std::vector<int> computeRotation(const int nodeIndex, const int vertexPosition, const bool isFlipped,
+        const std::vector<int>& order) const;
+    bool canShareFaceInSkeleton(const SPQRNode& node, const int edge1, const int edge2) const;
+public:
+    SPQRTree(const SubGraph* block);
+    const SubGraph* getBlock() const;
+    int size() const;
+    const SPQRNode& getNode(const int index) const;
+    bool isPlanar() const;
+    uint64_t numberOfEmbeddings() const;
+    bool canShareFace(const int from1, const int to1, const int from2, const int to2) const;
+    const Embedding* computeEmbedding(const std::vector<bool>& isFlipped,
+        const std::vector<std::vector<int>>& orders) const;
+};
+
+/**
+ * @class SPQREmbeddingsEnumerator
+ * @brief Lazily enumerates all the planar embeddings of a block, using its SPQR-tree.
+ *
+ * The enumerator keeps the current choice of mirroring of each R node and of order of
+ * the edges of each P node (with the first edge fixed, since embeddings are cyclic),
+ * and advances them like an odometer. Each embedding is built only when requested.
+ */
+class SPQREmbeddingsEnumerator {
+private:
+    const SPQRTree* tree_m;
+    std::vector<bool> isFlipped_m{};
+    std::vector<std::vector<int>> orders_m{};
+    bool hasEmbedding_m;
+public:
+    SPQREmbeddingsEnumerator(const SPQRTree* tree);
+    bool hasEmbedding() const;
+    const Embedding* getEmbedding() const;
+    void next();
+};
+
+#endif
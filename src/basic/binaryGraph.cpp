@@ -0,0 +1,274 @@
+#include "binaryGraph.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(int) == 4, "binary graph files store 32 bit offsets");
+
+static const char BINARY_GRAPH_MAGIC[8] = {'S', 'E', 'F', 'E', 'G', 'R', 'P', 'H'};
+static const uint32_t BINARY_GRAPH_VERSION = 1;
+
+/**
+ * @brief Opens and memory-maps a file in read-only mode.
+ *
+ * @param filename The name of the file to be mapped.
+ */
+MappedFile::MappedFile(const std::string& filename) {
+    fileDescriptor_m = open(filename.c_str(), O_RDONLY);
+    if (fileDescriptor_m == -1) return;
+    struct stat fileStat;
+    if (fstat(fileDescriptor_m, &fileStat) == -1 || fileStat.st_size == 0) return;
+    size_m = fileStat.st_size;
+    void* mapping = mmap(nullptr, size_m, PROT_READ, MAP_PRIVATE, fileDescriptor_m, 0);
+    if (mapping == MAP_FAILED) {
+        size_m = 0;
+        return;
+    }
+    data_m = static_cast<const char*>(mapping);
+}
+
+/**
+ * @brief Unmaps and closes the file.
+ */
+MappedFile::~MappedFile() {
+    if (data_m != nullptr)
+        munmap(const_cast<char*>(data_m), size_m);
+    if (fileDescriptor_m != -1)
+        close(fileDescriptor_m);
+}
+
+/**
+ * @brief Checks if the file has been successfully mapped.
+ *
+ * @return bool True if the file content is available, false otherwise.
+ */
+bool MappedFile::isOpen() const {
+    return data_m != nullptr;
+}
+
+/**
+ * @brief Gets the content of the mapped file.
+ *
+ * @return const char* Pointer to the first byte of the file.
+ */
+const char* MappedFile::data() const {
+    return data_m;
+}
+
+/**
+ * @brief Gets the size of the mapped file.
+ *
+ * @return size_t The number of bytes of the file.
+ */
+size_t MappedFile::size() const {
+    return size_m;
+}
+
+/**
+ * @brief Writes a graph to a file in the binary graph format, with neighbor
+ * indices of the given type.
+ *
+ * @tparam IndexType NarrowNodeIndex or NodeIndex.
+ * @param graph Pointer to the graph to be saved.
+ * @param filename The name of the output file.
+ * @return bool True if the file has been written, false otherwise.
+ */
+template <typename IndexType>
+static bool writeGraph(const Graph* graph, const std::string& filename) {
+    std::vector<int> offsets(graph->size()+1);
+    offsets[0] = 0;
+    for (int i = 0; i < graph->size(); ++i)
+        offsets[i+1] = offsets[i] + graph->getNode(i)->getDegree();
+    std::vector<IndexType> neighbors(offsets[graph->size()]);
+    for (int i = 0; i < graph->size(); ++i) {
+        const NeighborsRange nodeNeighbors = graph->getNode(i)->getNeighbors();
+        for (int j = 0; j < nodeNeighbors.size(); ++j)
+            neighbors[offsets[i]+j] = nodeNeighbors.getIndex(j);
+    }
+    BinaryGraphHeader header{};
+    std::memcpy(header.magic, BINARY_GRAPH_MAGIC, sizeof(header.magic));
+    header.version = BINARY_GRAPH_VERSION;
+    header.indexSize = sizeof(IndexType);
+    header.numberOfNodes = graph->size();
+    header.numberOfEdges = neighbors.size()/2;
+    std::ofstream outfile(filename, std::ios::binary);
+    if (!outfile.is_open()) {
+        std::cerr << "Unable to open file" << std::endl;
+        return false;
+    }
+    outfile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    outfile.write(reinterpret_cast<const char*>(offsets.data()), offsets.size()*sizeof(int));
+    outfile.write(reinterpret_cast<const char*>(neighbors.data()), neighbors.size()*sizeof(IndexType));
+    outfile.close();
+    return !outfile.fail();
+}
+
+/**
+ * @brief Checks that valid CSR arrays describe a simple undirected graph.
+ *
+ * The adjacency must have no self-loops, no node may list the same neighbor twice,
+ * and v must be a neighbor of u exactly when u is a neighbor of v. The transposed
+ * adjacency is built in order of the listing node and compared with the adjacency
+ * of each node through a marker array, in O(n + m) time.
+ *
+ * @tparam IndexType NarrowNodeIndex or NodeIndex.
+ * @param offsets Array of numberOfNodes+1 monotone offsets into the neighbors array.
+ * @param neighbors Array of neighbor indices, all smaller than numberOfNodes.
+ * @param numberOfNodes The number of nodes of the graph.
+ * @return bool True if the arrays describe a simple undirected graph, false otherwise.
+ */
+template <typename IndexType>
+static bool isSimpleUndirected(const int* offsets, const IndexType* neighbors, const int numberOfNodes) {
+    std::vector<int> marker(numberOfNodes, -1);
+    std::vector<int> transposedOffsets(numberOfNodes+1, 0);
+    for (int i = 0; i < numberOfNodes; ++i) {
+        for (int j = offsets[i]; j < offsets[i+1]; ++j) {
+            const int neighbor = neighbors[j];
+            if (neighbor == i || marker[neighbor] == i) return false;
+            marker[neighbor] = i;
+            ++transposedOffsets[neighbor+1];
+        }
+    }
+    for (int i = 0; i < numberOfNodes; ++i) {
+        transposedOffsets[i+1] += transposedOffsets[i];
+        if (transposedOffsets[i+1] != offsets[i+1]) return false;
+    }
+    std::vector<int> transposed(offsets[numberOfNodes]);
+    std::vector<int> positions(transposedOffsets.begin(), transposedOffsets.end()-1);
+    for (int i = 0; i < numberOfNodes; ++i)
+        for (int j = offsets[i]; j < offsets[i+1]; ++j)
+            transposed[positions[neighbors[j]]++] = i;
+    std::fill(marker.begin(), marker.end(), -1);
+    for (int i = 0; i < numberOfNodes; ++i) {
+        for (int j = offsets[i]; j < offsets[i+1]; ++j)
+            marker[neighbors[j]] = i;
+        for (int j = transposedOffsets[i]; j < transposedOffsets[i+1]; ++j)
+            if (marker[transposed[j]] != i) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Validates the CSR arrays of a mapped binary graph file and builds the
+ * graph over them.
+ *
+ * The offsets must start at 0, be monotone and end at the number of neighbor
+ * indices, every neighbor index must be a node of the graph, and the adjacency
+ * must describe a simple undirected graph (see isSimpleUndirected).
+ *
+ * @tparam IndexType NarrowNodeIndex or NodeIndex, as given by the header.
+ * @param file The mapped file, kept alive by the returned graph.
+ * @param numberOfNodes The number of nodes given by the header.
+ * @param numberOfEntries The number of neighbor indices given by the header.
+ * @return const Graph* Pointer to the loaded graph, or nullptr if the arrays are invalid.
+ */
+template <typename IndexType>
+static const Graph* buildMappedGraph(const std::shared_ptr<const MappedFile>& file,
+    const int numberOfNodes, const int numberOfEntries) {
+    const uint64_t expectedSize = sizeof(BinaryGraphHeader) + (uint64_t(numberOfNodes) + 1)*sizeof(int) +
+        uint64_t(numberOfEntries)*sizeof(IndexType);
+    if (file->size() != expectedSize) {
+        std::cerr << "Invalid binary graph file: wrong size" << std::endl;
+        return nullptr;
+    }
+    const int* offsets = reinterpret_cast<const int*>(file->data() + sizeof(BinaryGraphHeader));
+    const IndexType* neighbors = reinterpret_cast<const IndexType*>(offsets + numberOfNodes + 1);
+    bool valid = offsets[0] == 0 && offsets[numberOfNodes] == numberOfEntries;
+    for (int i = 0; valid && i < numberOfNodes; ++i)
+        valid = offsets[i] <= offsets[i+1];
+    for (int i = 0; valid && i < numberOfEntries; ++i)
+        valid = neighbors[i] < IndexType(numberOfNodes);
+    if (!valid) {
+        std::cerr << "Invalid binary graph file: corrupted arrays" << std::endl;
+        return nullptr;
+    }
+    if (!isSimpleUndirected(offsets, neighbors, numberOfNodes)) {
+        std::cerr << "Invalid binary graph file: not a simple undirected graph" << std::endl;
+        return nullptr;
+    }
+    return new Graph(numberOfNodes, offsets, neighbors, file);
+}
+
+/**
+ * @brief Saves a graph to a file in the binary graph format.
+ *
+ * The neighbor indices are written with 16 bits if the graph has at most
+ * MAX_NUMBER_OF_NARROW_NODES nodes, with 32 bits otherwise.
+ *
+ * @param graph Pointer to the graph to be saved.
+ * @param filename The name of the output file.
+ * @return bool True if the file has been written, false otherwise.
+ */
+bool BinaryGraph::saveToFile(const Graph* graph, const std::string& filename) {
+    if (graph->size() <= MAX_NUMBER_OF_NARROW_NODES)
+        return writeGraph<NarrowNodeIndex>(graph, filename);
+    return writeGraph<NodeIndex>(graph, filename);
+}
+
+/**
+ * @brief Loads a graph from a file in the binary graph format.
+ *
+ * The file is memory-mapped and the returned graph is compacted over the mapped
+ * arrays, which stay mapped as long as the graph exists. The header and the CSR
+ * arrays are validated before the graph is built, and a file whose arrays are
+ * out of range or do not describe a simple undirected graph is rejected.
+ *
+ * @param filename The name of the input file.
+ * @return const Graph* Pointer to the loaded graph, or nullptr if the file cannot
+ *         be opened or is not a valid binary graph file.
+ */
+const Graph* BinaryGraph::loadFromFile(const std::string& filename) {
+    std::shared_ptr<const MappedFile> file = std::make_shared<const MappedFile>(filename);
+    if (!file->isOpen()) {
+        std::cerr << "Unable to open file" << std::endl;
+        return nullptr;
+    }
+    if (file->size() < sizeof(BinaryGraphHeader)) {
+        std::cerr << "Invalid binary graph file: missing header" << std::endl;
+        return nullptr;
+    }
+    BinaryGraphHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, BINARY_GRAPH_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != BINARY_GRAPH_VERSION ||
+        (header.indexSize != sizeof(NarrowNodeIndex) && header.indexSize != sizeof(NodeIndex))) {
+        std::cerr << "Invalid binary graph file: unsupported format" << std::endl;
+        return nullptr;
+    }
+    const uint64_t maxNumberOfNodes = header.indexSize == sizeof(NarrowNodeIndex) ?
+        uint64_t(MAX_NUMBER_OF_NARROW_NODES) : uint64_t(MAX_NUMBER_OF_NODES);
+    if (header.numberOfNodes == 0 || header.numberOfNodes > maxNumberOfNodes ||
+        header.numberOfEdges > INT_MAX/2) {
+        std::cerr << "Invalid binary graph file: unsupported size" << std::endl;
+        return nullptr;
+    }
+    const int numberOfNodes = header.numberOfNodes;
+    const int numberOfEntries = 2*header.numberOfEdges;
+    if (header.indexSize == sizeof(NarrowNodeIndex))
+        return buildMappedGraph<NarrowNodeIndex>(file, numberOfNodes, numberOfEntries);
+    return buildMappedGraph<NodeIndex>(file, numberOfNodes, numberOfEntries);
+}
+
+/**
+ * @brief Converts a graph file from the text edge list format to the binary format.
+ *
+ * @param textFilename The name of the input file, in the text edge list format.
+ * @param binaryFilename The name of the output file.
+ * @return bool True if the conversion succeeded, false otherwise.
+ */
+bool BinaryGraph::convertTextFile(const std::string& textFilename, const std::string& binaryFilename) {
+    const Graph* graph = Graph::loadFromFile(textFilename);
+    if (graph == nullptr) return false;
+    std::unique_ptr<const Graph> graphPtr(graph);
+    return saveToFile(graph, binaryFilename);
+}
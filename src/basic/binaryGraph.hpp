@@ -0,0 +1,69 @@
+#ifndef MY_BINARY_GRAPH_H
+#define MY_BINARY_GRAPH_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include "graph.hpp"
+
+/**
+ * @struct BinaryGraphHeader
+ * @brief Header of the binary graph file format.
+ *
+ * A binary graph file is this header followed by the CSR arrays of the graph:
+ * numberOfNodes+1 offsets and then 2*numberOfEdges neighbor indices (each
+ * undirected edge is stored once per endpoint). Offsets are stored as 32 bit
+ * integers and neighbor indices as integers of indexSize bytes (2 if the graph
+ * has at most MAX_NUMBER_OF_NARROW_NODES nodes, 4 otherwise, the same width the
+ * graph uses for its own CSR arrays), in the byte order of the machine
+ * that wrote the file, so the arrays can be used in place once the file is
+ * memory-mapped.
+ */
+struct BinaryGraphHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t indexSize;
+    uint64_t numberOfNodes;
+    uint64_t numberOfEdges;
+};
+
+/**
+ * @class MappedFile
+ * @brief A read-only memory mapping of a whole file.
+ *
+ * The file is mapped when the object is constructed and unmapped when it is
+ * destroyed. If the file cannot be opened or mapped, isOpen() returns false.
+ */
+class MappedFile {
+private:
+    const char* data_m = nullptr;
+    size_t size_m = 0;
+    int fileDescriptor_m = -1;
+public:
+    MappedFile(const std::string& filename);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+    bool isOpen() const;
+    const char* data() const;
+    size_t size() const;
+};
+
+/**
+ * @class BinaryGraph
+ * @brief Reads and writes graphs in the binary graph file format.
+ *
+ * Loading memory-maps the file and builds an already compacted Graph whose CSR
+ * arrays point directly into the mapping, so no per-edge parsing or copying is done.
+ *
+ * @see BinaryGraphHeader
+ */
+class BinaryGraph {
+public:
+    static bool saveToFile(const Graph* graph, const std::string& filename);
+    static const Graph* loadFromFile(const std::string& filename);
+    static bool convertTextFile(const std::string& textFilename, const std::string& binaryFilename);
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "edgeIndex.hpp"
+
+#include <cassert>
+
+static const uint64_t EMPTY_SLOT = UINT64_MAX;
+
+/**
+ * @brief Computes the key of an undirected edge, independent of the order of its endpoints.
+ * 
+ * @param fromIndex The index of one endpoint.
+ * @param toIndex The index of the other endpoint.
+ * @return uint64_t The key of the edge.
+ */
+uint64_t EdgeIndex::computeKey(const int fromIndex, const int toIndex) {
+    assert(fromIndex >= 0 && toIndex >= 0);
+    const uint64_t min = fromIndex < toIndex ? fromIndex : toIndex;
+    const uint64_t max = fromIndex < toIndex ? toIndex : fromIndex;
+    return (min << 32) | max;
+}
+
+/**
+ * @brief Computes the home slot of a key (Fibonacci hashing).
+ * 
+ * @param key The key of an edge.
+ * @return size_t The index of the first slot to probe.
+ */
+size_t EdgeIndex::computeSlot(const uint64_t key) const {
+    return (key * 0x9E3779B97F4A7C15ull) >> shift_m;
+}
+
+/**
+ * @brief Rebuilds the table with the given number of slots.
+ * 
+ * @param capacity The new number of slots, a power of two.
+ */
+void EdgeIndex::rehash(const int capacity) {
+    std::vector<uint64_t> oldSlots(capacity, EMPTY_SLOT);
+    oldSlots.swap(slots_m);
+    shift_m = 64;
+    for (int c = capacity; c > 1; c >>= 1)
+        --shift_m;
+    for (const uint64_t key : oldSlots) {
+        if (key == EMPTY_SLOT) continue;
+        size_t slot = computeSlot(key);
+        while (slots_m[slot] != EMPTY_SLOT)
+            slot = (slot + 1) & (slots_m.size() - 1);
+        slots_m[slot] = key;
+    }
+}
+
+/**
+ * @brief Prepares the index to hold the given number of edges without rehashing.
+ * 
+ * @param numberOfEdges The expected number of edges.
+ */
+void EdgeIndex::reserve(const int numberOfEdges) {
+    int capacity = 8;
+    while (capacity < 2*numberOfEdges)
+        capacity <<= 1;
+    if (capacity > (int)slots_m.size())
+        rehash(capacity);
+}
+
+/**
+ * @brief Inserts an undirected edge in the index. Inserting an edge twice has no effect.
+ * 
+ * @param fromIndex The index of one endpoint.
+ * @param toIndex The index of the other endpoint.
+ */
+void EdgeIndex::insert(const int fromIndex, const int toIndex) {
+    if (2*(numberOfEdges_m+1) > (int)slots_m.size())
+        reserve(numberOfEdges_m+1);
+    const uint64_t key = computeKey(fromIndex, toIndex);
+    size_t slot = computeSlot(key);
+    while (slots_m[slot] != EMPTY_SLOT) {
+        if (slots_m[slot] == key) return;
+        slot = (slot + 1) & (slots_m.size() - 1);
+    }
+    slots_m[slot] = key;
+    ++numberOfEdges_m;
+}
+
+/**
+ * @brief Checks if an undirected edge is in the index.
+ * 
+ * @param fromIndex The index of one endpoint.
+ * @param toIndex The index of the other endpoint.
+ * @return bool True if the edge is in the index, false otherwise.
+ */
+bool EdgeIndex::contains(const int fromIndex, const int toIndex) const {
+    if (numberOfEdges_m == 0) return false;
+    const uint64_t key = computeKey(fromIndex, toIndex);
+    size_t slot = computeSlot(key);
+    while (slots_m[slot] != EMPTY_SLOT) {
+        if (slots_m[slot] == key) return true;
+        slot = (slot + 1) & (slots_m.size() - 1);
+    }
+    return false;
+}
+
+/**
+ * @brief Gets the number of edges in the index.
+ * 
+ * @return int The number of distinct edges inserted.
+ */
+int EdgeIndex::size() const {
+    return numberOfEdges_m;
+}
+
+/**
+ * @brief Checks if the index holds no edges.
+ * 
+ * @return bool True if no edge has been inserted, false otherwise.
+ */
+bool EdgeIndex::empty() const {
+    return numberOfEdges_m == 0;
+}
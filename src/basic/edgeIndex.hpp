@@ -0,0 +1,35 @@
+#ifndef MY_EDGE_INDEX_H
+#define MY_EDGE_INDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class EdgeIndex
+ * @brief A set of undirected edges supporting O(1) expected membership queries.
+ * 
+ * Each edge is stored once as the 64 bit key (min, max) of its endpoints in a
+ * flat open-addressing hash table with linear probing, so a query touches a few
+ * contiguous slots regardless of the degree of the endpoints.
+ * 
+ * @note The index is meant to be built once (reserve, then insert) and then
+ * only queried. Edges cannot be removed.
+ */
+class EdgeIndex {
+private:
+    std::vector<uint64_t> slots_m{};
+    int numberOfEdges_m = 0;
+    int shift_m = 64;
+    static uint64_t computeKey(const int fromIndex, const int toIndex);
+    size_t computeSlot(const uint64_t key) const;
+    void rehash(const int capacity);
+public:
+    void reserve(const int numberOfEdges);
+    void insert(const int fromIndex, const int toIndex);
+    bool contains(const int fromIndex, const int toIndex) const;
+    int size() const;
+    bool empty() const;
+};
+
+#endif
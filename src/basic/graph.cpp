@@ -1,4 +1,5 @@
 #include "graph.hpp"
+#include "graphParser.hpp"
 
 #include <iostream>
 #include <list>
@@ -10,7 +11,8 @@
  * @param index The index of the node.
  * @param graph Pointer to the graph to which this node belongs.
  */
-Node::Node(const int index, const Graph* graph) : index_m(index), graph_m(graph) {}
+Node::Node(const int index, const Graph* graph)
+: index_m(index), neighbors_m(graph->getMemoryResource()), graph_m(graph) {}
 
 /**
  * @brief Gets the index of the node.
@@ -24,28 +26,39 @@ int Node::getIndex() const {
 /**
  * @brief Gets the neighbors of the node.
  * 
- * @return std::vector<const Node*>& A vector of pointers to the neighboring nodes.
+ * If the graph is compacted the neighbors are read from its CSR arrays,
+ * otherwise from the node's own list.
+ * 
+ * @return NeighborsRange A read-only range of pointers to the neighboring nodes.
  */
-std::vector<const Node*>& Node::getNeighbors() {
-    return neighbors_m;
+NeighborsRange Node::getNeighbors() const {
+    if (graph_m->isCompact())
+        return graph_m->getCompactNeighbors(index_m);
+    const NodeIndex* begin = neighbors_m.data();
+    return NeighborsRange(begin, begin+neighbors_m.size(), graph_m->getNode(0));
 }
 
 /**
- * @brief Gets the neighbors of the node (const version).
+ * @brief Gets the number of neighbors of the node.
  * 
- * @return const std::vector<const Node*>& A vector of pointers to the neighboring nodes.
+ * @return int The degree of the node.
  */
-const std::vector<const Node*>& Node::getNeighbors() const {
-    return neighbors_m;
+int Node::getDegree() const {
+    return getNeighbors().size();
 }
 
 /**
  * @brief Adds a neighbor to the node.
  * 
- * @param neighbor Pointer to the neighboring node to be added.
+ * @param neighbor Pointer to the neighboring node to be added. It must belong
+ *                 to the same graph.
+ * 
+ * @pre The graph must not be compacted.
  */
 void Node::addNeighbor(const Node* neighbor) {
-    neighbors_m.push_back(neighbor);
+    assert(neighbor->getGraph() == graph_m);
+    assert(!graph_m->isCompact());
+    neighbors_m.push_back(neighbor->getIndex());
 }
 
 
@@ -61,12 +74,18 @@ const Graph* Node::getGraph() const {
 /**
  * @brief Constructs a Graph with a given number of nodes.
  * 
- * @param numberOfNodes The number of nodes in the graph.
+ * @param numberOfNodes The number of nodes in the graph, at most MAX_NUMBER_OF_NODES.
+ * @param resource The memory resource all the storage of the graph is allocated from.
  */
-Graph::Graph(const int numberOfNodes) {
+Graph::Graph(const int numberOfNodes, std::pmr::memory_resource* resource)
+: resource_m(resource), compactOffsets_m(resource), compactNeighbors_m(resource),
+compactNarrowNeighbors_m(resource), nodes_m(resource), nodesPointers_m(resource) {
     assert(numberOfNodes > 0);
+    assert(numberOfNodes <= MAX_NUMBER_OF_NODES);
+    nodes_m.reserve(numberOfNodes);
+    nodesPointers_m.reserve(numberOfNodes);
     for (int i = 0; i < numberOfNodes; ++i)
-        nodes_m.push_back(Node(i, this));
+        nodes_m.emplace_back(i, this);
     for (int i = 0; i < numberOfNodes; ++i)
         nodesPointers_m.push_back(&nodes_m[i]);
     assert(nodes_m.size() == nodesPointers_m.size());
@@ -74,6 +93,81 @@ Graph::Graph(const int numberOfNodes) {
         assert(getNode(i) == getNodes()[i]);
 }
 
+/**
+ * @brief Constructs an already compacted Graph directly over existing CSR arrays,
+ * without copying them (e.g. arrays of a memory-mapped file).
+ * 
+ * @param numberOfNodes The number of nodes in the graph.
+ * @param offsets Array of numberOfNodes+1 offsets into the neighbors array.
+ * @param neighbors Array of neighbor indices, offsets[numberOfNodes] entries long.
+ * @param storage Owner of the memory holding the arrays, kept alive as long as the graph.
+ */
+Graph::Graph(const int numberOfNodes, const int* offsets, const NodeIndex* neighbors, std::shared_ptr<const void> storage)
+: Graph(numberOfNodes) {
+    compactOffsetsData_m = offsets;
+    compactNeighborsData_m = neighbors;
+    compactStorage_m = std::move(storage);
+    isCompact_m = true;
+}
+
+/**
+ * @brief Constructs an already compacted Graph directly over existing CSR arrays
+ * with 16 bit neighbor indices, without copying them.
+ * 
+ * @param numberOfNodes The number of nodes in the graph, at most MAX_NUMBER_OF_NARROW_NODES.
+ * @param offsets Array of numberOfNodes+1 offsets into the neighbors array.
+ * @param neighbors Array of neighbor indices, offsets[numberOfNodes] entries long.
+ * @param storage Owner of the memory holding the arrays, kept alive as long as the graph.
+ */
+Graph::Graph(const int numberOfNodes, const int* offsets, const NarrowNodeIndex* neighbors, std::shared_ptr<const void> storage)
+: Graph(numberOfNodes) {
+    assert(numberOfNodes <= MAX_NUMBER_OF_NARROW_NODES);
+    compactOffsetsData_m = offsets;
+    compactNarrowNeighborsData_m = neighbors;
+    compactStorage_m = std::move(storage);
+    isCompact_m = true;
+    hasNarrowIndices_m = true;
+}
+
+/**
+ * @brief Constructs an already compacted Graph taking ownership of the given CSR arrays.
+ * 
+ * @param numberOfNodes The number of nodes in the graph.
+ * @param offsets Vector of numberOfNodes+1 offsets into the neighbors vector.
+ * @param neighbors Vector of neighbor indices, offsets[numberOfNodes] entries long.
+ */
+Graph::Graph(const int numberOfNodes, std::pmr::vector<int>&& offsets, std::pmr::vector<NodeIndex>&& neighbors)
+: Graph(numberOfNodes) {
+    assert(offsets.size() == size()+1);
+    assert(neighbors.size() == offsets[size()]);
+    compactOffsets_m = std::move(offsets);
+    compactNeighbors_m = std::move(neighbors);
+    compactOffsetsData_m = compactOffsets_m.data();
+    compactNeighborsData_m = compactNeighbors_m.data();
+    isCompact_m = true;
+}
+
+/**
+ * @brief Constructs an already compacted Graph taking ownership of the given CSR
+ * arrays with 16 bit neighbor indices.
+ * 
+ * @param numberOfNodes The number of nodes in the graph, at most MAX_NUMBER_OF_NARROW_NODES.
+ * @param offsets Vector of numberOfNodes+1 offsets into the neighbors vector.
+ * @param neighbors Vector of neighbor indices, offsets[numberOfNodes] entries long.
+ */
+Graph::Graph(const int numberOfNodes, std::pmr::vector<int>&& offsets, std::pmr::vector<NarrowNodeIndex>&& neighbors)
+: Graph(numberOfNodes) {
+    assert(numberOfNodes <= MAX_NUMBER_OF_NARROW_NODES);
+    assert(offsets.size() == size()+1);
+    assert(neighbors.size() == offsets[size()]);
+    compactOffsets_m = std::move(offsets);
+    compactNarrowNeighbors_m = std::move(neighbors);
+    compactOffsetsData_m = compactOffsets_m.data();
+    compactNarrowNeighborsData_m = compactNarrowNeighbors_m.data();
+    isCompact_m = true;
+    hasNarrowIndices_m = true;
+}
+
 /**
  * @brief Adds an edge between two nodes specified by their indices.
  * Assumes edge is not already in graph.
@@ -192,12 +286,21 @@ Node* Graph::getNode(const int index) {
 /**
  * @brief Gets all nodes in the graph.
  * 
- * @return const std::vector<const Node*> A vector of pointers to all nodes.
+ * @return const std::pmr::vector<const Node*>& A vector of pointers to all nodes.
  */
-const std::vector<const Node*> Graph::getNodes() const {
+const std::pmr::vector<const Node*>& Graph::getNodes() const {
     return nodesPointers_m;
 }
 
+/**
+ * @brief Gets the memory resource the storage of the graph is allocated from.
+ * 
+ * @return std::pmr::memory_resource* Pointer to the memory resource.
+ */
+std::pmr::memory_resource* Graph::getMemoryResource() const {
+    return resource_m;
+}
+
 /**
  * @brief Computes the intersection of this graph with another graph.
  * 
@@ -208,6 +311,7 @@ Graph* Graph::computeIntersection(const Graph* graph) const {
     assert(size() == graph->size());
     Graph* intersection = new Graph(size());
     computeIntersection(graph, intersection);
+    intersection->compact();
     return intersection;
 }
 
@@ -217,27 +321,64 @@ Graph* Graph::computeIntersection(const Graph* graph) const {
  * 
  * @param graph Pointer to the other graph.
  * @param intersection Pointer to the graph where the intersection will be stored.
+ * 
+ * @see mergeEdges
  */
 void Graph::computeIntersection(const Graph* graph, Graph* intersection) const {
     assert(size() == graph->size());
     assert(size() == intersection->size());
-    bool isEdgeInGraph1[size()];
-    bool isEdgeInGraph2[size()];
-    for (int i = 0; i < size(); ++i) {
-        const Node* node1 = getNode(i);
-        const Node* node2 = graph->getNode(i);
-        for (int j = 0; j < size(); ++j) {
-            isEdgeInGraph1[j] = false;
-            isEdgeInGraph2[j] = false;
+    for (const MergedEdge& edge : mergeEdges(graph))
+        if (edge.isInFirst && edge.isInSecond && edge.fromIndex < edge.toIndex)
+            intersection->addEdge(edge.fromIndex, edge.toIndex);
+}
+
+/**
+ * @brief Merges the edges of this graph with the edges of another graph on the
+ * same nodes, in O(n + m) time.
+ * 
+ * Each edge of the union is reported once, as (fromIndex, toIndex) with
+ * fromIndex <= toIndex, together with the graphs containing it. Edges are sorted
+ * by fromIndex and then by toIndex.
+ * 
+ * The edges are first collected column by column (by toIndex, ascending), using a
+ * single marker array to detect an edge already found in the other graph, and
+ * then bucketed by row (fromIndex), which keeps each row sorted by column.
+ * 
+ * @param graph Pointer to the other graph.
+ * @return std::vector<MergedEdge> The edges of the union of the two graphs.
+ * 
+ * @pre The two graphs must have the same number of nodes.
+ */
+std::vector<MergedEdge> Graph::mergeEdges(const Graph* graph) const {
+    assert(size() == graph->size());
+    const Graph* graphs[2] = {this, graph};
+    std::vector<int> marker(size(), -1);
+    std::vector<MergedEdge> edgesByColumn{};
+    for (int column = 0; column < size(); ++column) {
+        const int columnStart = edgesByColumn.size();
+        for (int g = 0; g < 2; ++g) {
+            const NeighborsRange neighbors = graphs[g]->getNode(column)->getNeighbors();
+            for (int k = 0; k < neighbors.size(); ++k) {
+                const int row = neighbors.getIndex(k);
+                if (row > column) continue;
+                if (marker[row] < columnStart) {
+                    marker[row] = edgesByColumn.size();
+                    edgesByColumn.push_back({row, column, false, false});
+                }
+                MergedEdge& edge = edgesByColumn[marker[row]];
+                (g == 0 ? edge.isInFirst : edge.isInSecond) = true;
+            }
         }
-        for (const Node* neighbor : node1->getNeighbors())
-            isEdgeInGraph1[neighbor->getIndex()] = true;
-        for (const Node* neighbor : node2->getNeighbors())
-            isEdgeInGraph2[neighbor->getIndex()] = true;
-        for (int j = 0; j < size(); ++j)
-            if (isEdgeInGraph1[j] && isEdgeInGraph2[j] && i < j)
-                intersection->addEdge(i, j);
     }
+    std::vector<int> rowOffsets(size()+1, 0);
+    for (const MergedEdge& edge : edgesByColumn)
+        ++rowOffsets[edge.fromIndex+1];
+    for (int row = 0; row < size(); ++row)
+        rowOffsets[row+1] += rowOffsets[row];
+    std::vector<MergedEdge> edges(edgesByColumn.size());
+    for (const MergedEdge& edge : edgesByColumn)
+        edges[rowOffsets[edge.fromIndex]++] = edge;
+    return edges;
 }
 
 /**
@@ -246,8 +387,13 @@ void Graph::computeIntersection(const Graph* graph, Graph* intersection) const {
  * @param fromIndex The index of the starting node.
  * @param toIndex The index of the ending node.
  * @return bool True if there is an edge, false otherwise.
+ * 
+ * @note Uses the edge index if it has been built, otherwise scans the neighbors
+ * of the endpoint with the smaller degree.
  */
 bool Graph::hasEdge(int fromIndex, int toIndex) const {
+    if (hasEdgeIndex_m)
+        return edgeIndex_m.contains(fromIndex, toIndex);
     if (getNode(fromIndex)->getNeighbors().size() > getNode(toIndex)->getNeighbors().size()) {
         int temp = fromIndex;
         fromIndex = toIndex;
@@ -293,20 +439,168 @@ bool Graph::isConnected() const {
  * @return int The number of edges.
  */
 int Graph::numberOfEdges() const {
+    if (isCompact_m)
+        return compactOffsetsData_m[size()]/2;
     int edges = 0;
     for (int i = 0; i < size(); ++i)
         edges += getNode(i)->getNeighbors().size();
     return edges/2;
 }
 
+/**
+ * @brief Compacts the graph into a CSR (compressed sparse row) representation.
+ *
+ * The neighbor lists of all nodes are moved, in order, into one contiguous array
+ * indexed by an offsets array, and the per-node lists are released. The order of
+ * the neighbors is preserved, so compacting an embedding keeps its rotation system.
+ * The neighbor indices are stored with 16 bits if the graph has at most
+ * MAX_NUMBER_OF_NARROW_NODES nodes, with 32 bits otherwise.
+ * After this call no more edges can be added to the graph.
+ */
+void Graph::compact() {
+    if (isCompact_m) return;
+    compactOffsets_m.resize(size()+1);
+    compactOffsets_m[0] = 0;
+    for (int i = 0; i < size(); ++i)
+        compactOffsets_m[i+1] = compactOffsets_m[i] + nodes_m[i].neighbors_m.size();
+    auto fill = [this](auto& compactNeighbors) {
+        compactNeighbors.resize(compactOffsets_m[size()]);
+        for (int i = 0; i < size(); ++i) {
+            std::pmr::vector<NodeIndex>& neighbors = nodes_m[i].neighbors_m;
+            std::copy(neighbors.begin(), neighbors.end(), compactNeighbors.begin() + compactOffsets_m[i]);
+            std::pmr::vector<NodeIndex>(resource_m).swap(neighbors);
+        }
+    };
+    hasNarrowIndices_m = size() <= MAX_NUMBER_OF_NARROW_NODES;
+    if (hasNarrowIndices_m) fill(compactNarrowNeighbors_m);
+    else fill(compactNeighbors_m);
+    compactOffsetsData_m = compactOffsets_m.data();
+    compactNeighborsData_m = compactNeighbors_m.data();
+    compactNarrowNeighborsData_m = compactNarrowNeighbors_m.data();
+    isCompact_m = true;
+}
+
+/**
+ * @brief Adds the given edges to the graph and compacts it, in a single pass.
+ *
+ * Equivalent to calling addEdge for each edge, in order, followed by compact(),
+ * but the CSR arrays are allocated once and filled directly, without building
+ * the per-node neighbor lists first.
+ *
+ * @param edges The edges to be added, as pairs of node indices.
+ *
+ * @pre The graph must not have edges yet.
+ */
+void Graph::compactFromEdges(const std::vector<std::pair<int, int>>& edges) {
+    assert(!isCompact_m);
+    assert(numberOfEdges() == 0);
+    compactOffsets_m.assign(size()+1, 0);
+    for (const std::pair<int, int>& edge : edges) {
+        assert(edge.first >= 0 && edge.first < size());
+        assert(edge.second >= 0 && edge.second < size());
+        ++compactOffsets_m[edge.first+1];
+        ++compactOffsets_m[edge.second+1];
+    }
+    for (int i = 0; i < size(); ++i)
+        compactOffsets_m[i+1] += compactOffsets_m[i];
+    auto fill = [this, &edges](auto& compactNeighbors) {
+        compactNeighbors.resize(compactOffsets_m[size()]);
+        std::vector<int> positions(compactOffsets_m.begin(), compactOffsets_m.end()-1);
+        for (const std::pair<int, int>& edge : edges) {
+            compactNeighbors[positions[edge.first]++] = edge.second;
+            compactNeighbors[positions[edge.second]++] = edge.first;
+        }
+    };
+    hasNarrowIndices_m = size() <= MAX_NUMBER_OF_NARROW_NODES;
+    if (hasNarrowIndices_m) fill(compactNarrowNeighbors_m);
+    else fill(compactNeighbors_m);
+    compactOffsetsData_m = compactOffsets_m.data();
+    compactNeighborsData_m = compactNeighbors_m.data();
+    compactNarrowNeighborsData_m = compactNarrowNeighbors_m.data();
+    isCompact_m = true;
+}
+
+/**
+ * @brief Checks if the graph has been compacted into its CSR representation.
+ * 
+ * @return bool True if the graph is compacted, false otherwise.
+ */
+bool Graph::isCompact() const {
+    return isCompact_m;
+}
+
+/**
+ * @brief Checks if the CSR arrays of the graph store 16 bit neighbor indices.
+ * 
+ * @return bool True if the graph is compacted with NarrowNodeIndex indices, false otherwise.
+ */
+bool Graph::hasNarrowIndices() const {
+    return hasNarrowIndices_m;
+}
+
+/**
+ * @brief Builds the edge index of the graph, used by hasEdge from then on.
+ * 
+ * @pre The graph must be compacted, so that no edge can be added afterwards.
+ */
+void Graph::buildEdgeIndex() {
+    assert(isCompact_m);
+    if (hasEdgeIndex_m) return;
+    edgeIndex_m.reserve(numberOfEdges());
+    for (int i = 0; i < size(); ++i) {
+        const NeighborsRange neighbors = getCompactNeighbors(i);
+        for (int j = 0; j < neighbors.size(); ++j)
+            if (i < neighbors.getIndex(j))
+                edgeIndex_m.insert(i, neighbors.getIndex(j));
+    }
+    hasEdgeIndex_m = true;
+}
+
+/**
+ * @brief Checks if the edge index of the graph has been built.
+ * 
+ * @return bool True if hasEdge uses the edge index, false otherwise.
+ */
+bool Graph::hasEdgeIndex() const {
+    return hasEdgeIndex_m;
+}
+
+/**
+ * @brief Loads a graph from a file in the text edge list format.
+ * 
+ * @param filename The name of the input file.
+ * @return const Graph* Pointer to the loaded (compacted) graph, or nullptr if the
+ *         file cannot be opened or contains malformed lines.
+ * 
+ * @see GraphParser
+ */
+const Graph* Graph::loadFromFile(const std::string& filename) {
+    return GraphParser::parseFile(filename);
+}
+
+/**
+ * @brief Gets the neighbors of a node from the CSR arrays of a compacted graph.
+ * 
+ * @param index The index of the node.
+ * @return NeighborsRange A read-only range over the node's slice of the CSR arrays.
+ */
+NeighborsRange Graph::getCompactNeighbors(const int index) const {
+    assert(isCompact_m);
+    const int begin = compactOffsetsData_m[index];
+    const int end = compactOffsetsData_m[index+1];
+    if (hasNarrowIndices_m)
+        return NeighborsRange(compactNarrowNeighborsData_m + begin, compactNarrowNeighborsData_m + end, &nodes_m[0]);
+    return NeighborsRange(compactNeighborsData_m + begin, compactNeighborsData_m + end, &nodes_m[0]);
+}
+
 /**
  * @brief Constructs a SubGraph with a given number of nodes and an original graph.
  * 
  * @param numberOfNodes The number of nodes in the subgraph.
  * @param graph Pointer to the original graph.
  */
-SubGraph::SubGraph(const int numberOfNodes, const Graph* graph) 
-: Graph(numberOfNodes), originalNodes_m(numberOfNodes), originalGraph_m(graph) {
+SubGraph::SubGraph(const int numberOfNodes, const Graph* graph, std::pmr::memory_resource* resource)
+: Graph(numberOfNodes, resource), originalGraph_m(graph), originalNodes_m(numberOfNodes, resource) {
     assert(numberOfNodes <= graph->size());
 }
 
@@ -338,7 +632,7 @@ void SubGraph::setOriginalNode(const Node* node, const Node* originalNode) {
 void SubGraph::print() const {
     for (auto& node : nodes_m) {
         const int originalIndex = getOriginalNode(&node)->getIndex();
-        const std::vector<const Node*>& neighbors = node.getNeighbors();
+        const NeighborsRange neighbors = node.getNeighbors();
         std::cout << "node: " << originalIndex << " neighbors: " << neighbors.size() << " [ ";
         for (const Node* neighbor : neighbors)
             std::cout << getOriginalNode(neighbor)->getIndex() << " ";
@@ -3,13 +3,43 @@
 
 #include <vector>
 #include <optional>
+#include <memory>
+#include <memory_resource>
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <cstdint>
+#include <limits>
+#include <cassert>
 
 #include "utils.hpp"
+#include "edgeIndex.hpp"
+
+/**
+ * @brief The integer types used to store node indices in neighbor lists and CSR arrays.
+ * 
+ * The width is chosen by each graph when it is compacted: a graph with at most
+ * MAX_NUMBER_OF_NARROW_NODES nodes (as most segments of the recursion) stores its CSR
+ * arrays with 16 bit indices, which halves its adjacency storage, a larger one with
+ * 32 bit indices. The neighbor lists of a graph not compacted yet use 32 bit indices.
+ * Node indices in the interface of the classes are still plain ints.
+ */
+typedef uint32_t NodeIndex;
+typedef uint16_t NarrowNodeIndex;
+
+/**
+ * @brief The maximum number of nodes of a graph whose CSR arrays use NarrowNodeIndex.
+ */
+constexpr int MAX_NUMBER_OF_NARROW_NODES = int(std::numeric_limits<NarrowNodeIndex>::max()) + 1;
+
+/**
+ * @brief The maximum number of nodes of a graph.
+ */
+constexpr int64_t MAX_NUMBER_OF_NODES = int64_t(INT32_MAX);
 
 class Graph;
+class NeighborsRange;
 
 /**
  * @class Node
@@ -18,37 +48,176 @@ class Graph;
  * The Node class encapsulates the properties and behaviors of a node within a graph.
  * Each node has a unique index, a list of neighboring nodes, and a reference
  * to the graph it belongs to.
+ * 
+ * @note Neighbors are stored as indices of nodes of the same graph. Once the graph
+ * is compacted, the node's own list is released and its neighbors are read from
+ * the graph's CSR arrays.
  */
 class Node {
 private:
     const int index_m;
-    std::vector<const Node*> neighbors_m;
+    std::pmr::vector<NodeIndex> neighbors_m;
     const Graph* graph_m;
+    friend class Graph;
 public:
     Node(const int index, const Graph* graph);
     int getIndex() const;
-    const std::vector<const Node*>& getNeighbors() const;
-    std::vector<const Node*>& getNeighbors();
+    NeighborsRange getNeighbors() const;
+    int getDegree() const;
     void addNeighbor(const Node* neighbor);
     const Graph* getGraph() const;
 };
 
+/**
+ * @class NeighborsRange
+ * @brief A read-only view over the neighbors of a node.
+ * 
+ * The range walks a contiguous array of node indices, of either width, and resolves
+ * each index to the corresponding node of the owning graph, so it can be used exactly
+ * like a container of node pointers (range-for, size(), operator[]).
+ */
+class NeighborsRange {
+private:
+    const void* begin_m;
+    int size_m;
+    bool isNarrow_m;
+    const Node* nodes_m;
+
+    /**
+     * @brief Reads the index at the given position of an array of indices of either width.
+     */
+    static int indexAt(const void* begin, const int position, const bool isNarrow) {
+        if (isNarrow) return static_cast<const NarrowNodeIndex*>(begin)[position];
+        return static_cast<const NodeIndex*>(begin)[position];
+    }
+public:
+    /**
+     * @class Iterator
+     * @brief Forward iterator yielding pointers to the neighboring nodes.
+     */
+    class Iterator {
+    private:
+        const void* begin_m;
+        int position_m;
+        bool isNarrow_m;
+        const Node* nodes_m;
+    public:
+        Iterator(const void* begin, const int position, const bool isNarrow, const Node* nodes)
+        : begin_m(begin), position_m(position), isNarrow_m(isNarrow), nodes_m(nodes) {}
+        const Node* operator*() const { return nodes_m + indexAt(begin_m, position_m, isNarrow_m); }
+        Iterator& operator++() { ++position_m; return *this; }
+        bool operator!=(const Iterator& other) const { return position_m != other.position_m; }
+        bool operator==(const Iterator& other) const { return position_m == other.position_m; }
+    };
+
+    /**
+     * @brief Constructs a range over the indices in [begin, end).
+     * 
+     * @param begin Pointer to the first neighbor index.
+     * @param end Pointer past the last neighbor index.
+     * @param nodes Pointer to the first node of the graph owning the neighbors.
+     */
+    NeighborsRange(const NodeIndex* begin, const NodeIndex* end, const Node* nodes)
+    : begin_m(begin), size_m(end - begin), isNarrow_m(false), nodes_m(nodes) {}
+
+    /**
+     * @brief Constructs a range over the 16 bit indices in [begin, end).
+     * 
+     * @param begin Pointer to the first neighbor index.
+     * @param end Pointer past the last neighbor index.
+     * @param nodes Pointer to the first node of the graph owning the neighbors.
+     */
+    NeighborsRange(const NarrowNodeIndex* begin, const NarrowNodeIndex* end, const Node* nodes)
+    : begin_m(begin), size_m(end - begin), isNarrow_m(true), nodes_m(nodes) {}
+    Iterator begin() const { return Iterator(begin_m, 0, isNarrow_m, nodes_m); }
+    Iterator end() const { return Iterator(begin_m, size_m, isNarrow_m, nodes_m); }
+    int size() const { return size_m; }
+    bool empty() const { return size_m == 0; }
+
+    /**
+     * @brief Retrieves the neighbor at the given position of the range.
+     * 
+     * @param position The position of the neighbor in the range.
+     * @return const Node* Pointer to the neighboring node.
+     */
+    const Node* operator[](const int position) const {
+        assert(position >= 0 && position < size());
+        return nodes_m + indexAt(begin_m, position, isNarrow_m);
+    }
+
+    /**
+     * @brief Retrieves the index of the neighbor at the given position, without
+     * touching the neighbor node itself.
+     * 
+     * @param position The position of the neighbor in the range.
+     * @return int The index of the neighboring node.
+     */
+    int getIndex(const int position) const {
+        assert(position >= 0 && position < size());
+        return indexAt(begin_m, position, isNarrow_m);
+    }
+};
+
+/**
+ * @struct MergedEdge
+ * @brief An edge of the union of two graphs on the same nodes.
+ * 
+ * Records the endpoints of the edge (fromIndex <= toIndex) and which of the two
+ * graphs contain it.
+ */
+struct MergedEdge {
+    int fromIndex;
+    int toIndex;
+    bool isInFirst;
+    bool isInSecond;
+};
+
 /**
  * @class Graph
  * @brief A class representing an undirected graph structure with nodes and edges.
  * 
  * The Graph class provides functionalities to manage a graph, including adding edges,
  * retrieving nodes, computing bipartitions, and intersections with other graphs.
+ * 
+ * Once all of its edges are added, a graph can be compacted into a frozen CSR
+ * (compressed sparse row) representation: an offsets array and one contiguous
+ * array of neighbor indices, 16 bit wide if the graph has at most
+ * MAX_NUMBER_OF_NARROW_NODES nodes, 32 bit wide otherwise (see NodeIndex).
+ * A compacted graph cannot receive new edges.
+ * All the storage of a graph (nodes, neighbor lists, CSR arrays) is allocated
+ * from the memory resource given at construction, so short-lived graphs can be
+ * allocated from an arena (e.g. a std::pmr::monotonic_buffer_resource).
+ * A compacted graph can also build an edge index, after which hasEdge answers
+ * in O(1) expected time instead of scanning a neighbor list.
  */
 class Graph {
 private:
+    std::pmr::memory_resource* resource_m;
+    std::pmr::vector<int> compactOffsets_m;
+    std::pmr::vector<NodeIndex> compactNeighbors_m;
+    std::pmr::vector<NarrowNodeIndex> compactNarrowNeighbors_m;
+    const int* compactOffsetsData_m = nullptr;
+    const NodeIndex* compactNeighborsData_m = nullptr;
+    const NarrowNodeIndex* compactNarrowNeighborsData_m = nullptr;
+    std::shared_ptr<const void> compactStorage_m{};
+    bool isCompact_m = false;
+    bool hasNarrowIndices_m = false;
+    EdgeIndex edgeIndex_m{};
+    bool hasEdgeIndex_m = false;
     bool bfsBipartition(int node, std::vector<int>& bipartition) const;
+    NeighborsRange getCompactNeighbors(const int index) const;
+    friend class Node;
 protected:
-    std::vector<Node> nodes_m;
-    std::vector<const Node*> nodesPointers_m;
+    std::pmr::vector<Node> nodes_m;
+    std::pmr::vector<const Node*> nodesPointers_m;
 public:
-    Graph(const int numberOfNodes);
-    const std::vector<const Node*> getNodes() const;
+    Graph(const int numberOfNodes, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    Graph(const int numberOfNodes, const int* offsets, const NodeIndex* neighbors, std::shared_ptr<const void> storage);
+    Graph(const int numberOfNodes, const int* offsets, const NarrowNodeIndex* neighbors, std::shared_ptr<const void> storage);
+    Graph(const int numberOfNodes, std::pmr::vector<int>&& offsets, std::pmr::vector<NodeIndex>&& neighbors);
+    Graph(const int numberOfNodes, std::pmr::vector<int>&& offsets, std::pmr::vector<NarrowNodeIndex>&& neighbors);
+    const std::pmr::vector<const Node*>& getNodes() const;
+    std::pmr::memory_resource* getMemoryResource() const;
     const Node* getNode(const int index) const;
     Node* getNode(const int index);
     void addEdge(Node* from, Node* to);
@@ -58,32 +227,17 @@ public:
     const std::optional<std::vector<int>> computeBipartition() const;
     Graph* computeIntersection(const Graph* graph) const;
     void computeIntersection(const Graph* graph, Graph* intersection) const;
+    std::vector<MergedEdge> mergeEdges(const Graph* graph) const;
     bool hasEdge(int fromIndex, int toIndex) const;
     bool isConnected() const;
     int numberOfEdges() const;
-    static const Graph* loadFromFile(std::string filename) {
-        int nodesNumber{};
-        std::ifstream infile(filename);
-        if (infile.is_open()) {
-            std::string line;
-            std::getline(infile, line);
-            nodesNumber = stoi(line);
-            Graph* graph = new Graph(nodesNumber);
-            int fromIndex, toIndex;
-            while (std::getline(infile, line)) {
-                if (line.find("//") == 0)
-                    continue;
-                std::istringstream iss(line);
-                if (iss >> fromIndex >> toIndex)
-                    graph->addEdge(fromIndex, toIndex);
-            }
-            infile.close();
-            return graph;
-        } else {
-            std::cerr << "Unable to open file" << std::endl;
-            return nullptr;
-        }
-    }
+    void compact();
+    void compactFromEdges(const std::vector<std::pair<int, int>>& edges);
+    bool isCompact() const;
+    bool hasNarrowIndices() const;
+    void buildEdgeIndex();
+    bool hasEdgeIndex() const;
+    static const Graph* loadFromFile(const std::string& filename);
 };
 
 /**
@@ -99,7 +253,8 @@ private:
     const Graph* originalGraph_m;
     ArrayPointers<const Node> originalNodes_m;
 public:
-    SubGraph(const int numberOfNodes, const Graph* graph);
+    SubGraph(const int numberOfNodes, const Graph* graph,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     const Node* getOriginalNode(const Node* node) const;
     void setOriginalNode(const Node* node, const Node* originalNode);
     void print() const override;
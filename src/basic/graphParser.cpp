@@ -0,0 +1,379 @@
+#include "graphParser.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <charconv>
+#include <cstring>
+#include <thread>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+static const size_t READ_BLOCK_SIZE = 1 << 20;
+static const size_t MIN_CHUNK_SIZE = 1 << 16;
+static const int MAX_REPORTED_ERRORS = 10;
+
+/**
+ * @struct ParsedChunk
+ * @brief Result of parsing a contiguous range of lines of the input.
+ */
+struct ParsedChunk {
+    const char* begin_m = nullptr;
+    const char* end_m = nullptr;
+    std::vector<int> edges_m{};
+    std::vector<int> degrees_m{};
+    std::vector<std::pair<int, const char*>> errors_m{};
+    int numberOfLines_m = 0;
+};
+
+static bool isBlank(const char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char* skipBlanks(const char* position, const char* end) {
+    while (position < end && isBlank(*position))
+        ++position;
+    return position;
+}
+
+/**
+ * @brief Checks if nothing but blanks and an optional "//" comment is left on a line.
+ */
+static bool isRestOfLineEmpty(const char* position, const char* lineEnd) {
+    position = skipBlanks(position, lineEnd);
+    if (position == lineEnd) return true;
+    return lineEnd - position >= 2 && position[0] == '/' && position[1] == '/';
+}
+
+static const char* findLineEnd(const char* position, const char* end) {
+    const char* lineEnd = static_cast<const char*>(std::memchr(position, '\n', end - position));
+    return lineEnd == nullptr ? end : lineEnd;
+}
+
+/**
+ * @brief Parses one edge line, appending the edge to the chunk or recording an error.
+ *
+ * @return const char* Pointer to the first character of the next line.
+ */
+static const char* parseEdgeLine(const char* position, const char* end, const int numberOfNodes, ParsedChunk& chunk) {
+    const char* lineEnd = findLineEnd(position, end);
+    const char* next = lineEnd == end ? end : lineEnd+1;
+    const int lineNumber = chunk.numberOfLines_m++;
+    if (isRestOfLineEmpty(position, lineEnd))
+        return next;
+    int fromIndex, toIndex;
+    position = skipBlanks(position, lineEnd);
+    std::from_chars_result result = std::from_chars(position, lineEnd, fromIndex);
+    if (result.ec != std::errc() || result.ptr == lineEnd || !isBlank(*result.ptr)) {
+        chunk.errors_m.push_back({lineNumber, "expected two node indices"});
+        return next;
+    }
+    position = skipBlanks(result.ptr, lineEnd);
+    result = std::from_chars(position, lineEnd, toIndex);
+    if (result.ec != std::errc()) {
+        chunk.errors_m.push_back({lineNumber, "expected two node indices"});
+        return next;
+    }
+    if (!isRestOfLineEmpty(result.ptr, lineEnd)) {
+        chunk.errors_m.push_back({lineNumber, "unexpected characters after edge"});
+        return next;
+    }
+    if (fromIndex < 0 || fromIndex >= numberOfNodes || toIndex < 0 || toIndex >= numberOfNodes) {
+        chunk.errors_m.push_back({lineNumber, "node index out of range"});
+        return next;
+    }
+    chunk.edges_m.push_back(fromIndex);
+    chunk.edges_m.push_back(toIndex);
+    ++chunk.degrees_m[fromIndex];
+    ++chunk.degrees_m[toIndex];
+    return next;
+}
+
+static void parseChunk(const int numberOfNodes, ParsedChunk* chunk) {
+    chunk->degrees_m.assign(numberOfNodes, 0);
+    const char* position = chunk->begin_m;
+    while (position < chunk->end_m)
+        position = parseEdgeLine(position, chunk->end_m, numberOfNodes, *chunk);
+}
+
+/**
+ * @brief Parses the header of the input (the number of nodes), skipping
+ * leading blank and comment lines.
+ *
+ * @param numberOfNodes Output, the parsed number of nodes.
+ * @param lineNumber Output, the number of lines consumed.
+ * @return const char* Pointer to the first line after the header, or nullptr
+ *         if the header is missing or malformed.
+ */
+static const char* parseHeader(const char* position, const char* end, int& numberOfNodes, int& lineNumber) {
+    lineNumber = 0;
+    while (position < end) {
+        const char* lineEnd = findLineEnd(position, end);
+        const char* next = lineEnd == end ? end : lineEnd+1;
+        ++lineNumber;
+        if (isRestOfLineEmpty(position, lineEnd)) {
+            position = next;
+            continue;
+        }
+        position = skipBlanks(position, lineEnd);
+        std::from_chars_result result = std::from_chars(position, lineEnd, numberOfNodes);
+        if (result.ec != std::errc() || numberOfNodes <= 0 || !isRestOfLineEmpty(result.ptr, lineEnd)) {
+            std::cerr << "Error at line " << lineNumber << ": expected a positive number of nodes" << std::endl;
+            return nullptr;
+        }
+        if (numberOfNodes > MAX_NUMBER_OF_NODES) {
+            std::cerr << "Error at line " << lineNumber << ": at most " << MAX_NUMBER_OF_NODES
+                << " nodes are supported by this build" << std::endl;
+            return nullptr;
+        }
+        return next;
+    }
+    std::cerr << "Error: missing number of nodes" << std::endl;
+    return nullptr;
+}
+
+/**
+ * @brief Reports the malformed lines of the parsed chunks, at most MAX_REPORTED_ERRORS of them.
+ *
+ * @param chunks The parsed chunks, in input order.
+ * @param headerLines The number of lines preceding the first chunk.
+ * @return int The number of malformed lines.
+ */
+static int reportErrors(const std::vector<ParsedChunk>& chunks, const int headerLines) {
+    int numberOfErrors = 0;
+    int firstLine = headerLines + 1;
+    for (const ParsedChunk& chunk : chunks) {
+        for (const std::pair<int, const char*>& error : chunk.errors_m) {
+            if (numberOfErrors < MAX_REPORTED_ERRORS)
+                std::cerr << "Error at line " << firstLine + error.first << ": " << error.second << std::endl;
+            ++numberOfErrors;
+        }
+        firstLine += chunk.numberOfLines_m;
+    }
+    if (numberOfErrors > MAX_REPORTED_ERRORS)
+        std::cerr << "... and " << numberOfErrors - MAX_REPORTED_ERRORS << " more malformed lines" << std::endl;
+    return numberOfErrors;
+}
+
+/**
+ * @brief Builds the compacted graph holding the edges of the parsed chunks.
+ *
+ * The CSR arrays are allocated once and filled in input order, with neighbor
+ * indices of the width the graph chooses for its size (see NodeIndex).
+ *
+ * @param numberOfNodes The number of nodes of the graph.
+ * @param chunks The parsed chunks, in input order.
+ * @return const Graph* Pointer to the built graph.
+ */
+static const Graph* buildGraph(const int numberOfNodes, const std::vector<ParsedChunk>& chunks) {
+    std::pmr::vector<int> offsets(numberOfNodes+1);
+    offsets[0] = 0;
+    for (int i = 0; i < numberOfNodes; ++i) {
+        int degree = 0;
+        for (const ParsedChunk& chunk : chunks)
+            degree += chunk.degrees_m[i];
+        offsets[i+1] = offsets[i] + degree;
+    }
+    auto fill = [&offsets, &chunks](auto& neighbors) {
+        neighbors.resize(offsets[offsets.size()-1]);
+        std::vector<int> positions(offsets.begin(), offsets.end()-1);
+        for (const ParsedChunk& chunk : chunks) {
+            for (size_t i = 0; i < chunk.edges_m.size(); i += 2) {
+                const int fromIndex = chunk.edges_m[i];
+                const int toIndex = chunk.edges_m[i+1];
+                neighbors[positions[fromIndex]++] = toIndex;
+                neighbors[positions[toIndex]++] = fromIndex;
+            }
+        }
+    };
+    if (numberOfNodes <= MAX_NUMBER_OF_NARROW_NODES) {
+        std::pmr::vector<NarrowNodeIndex> neighbors;
+        fill(neighbors);
+        return new Graph(numberOfNodes, std::move(offsets), std::move(neighbors));
+    }
+    std::pmr::vector<NodeIndex> neighbors;
+    fill(neighbors);
+    return new Graph(numberOfNodes, std::move(offsets), std::move(neighbors));
+}
+
+/**
+ * @brief Loads a graph from a file in the text edge list format.
+ *
+ * The file is read in large blocks into a single buffer, then parsed.
+ *
+ * @param filename The name of the input file.
+ * @param numberOfThreads The maximum number of threads used for parsing.
+ * @return const Graph* Pointer to the loaded (compacted) graph, or nullptr if the
+ *         file cannot be opened or contains malformed lines.
+ */
+const Graph* GraphParser::parseFile(const std::string& filename, const int numberOfThreads) {
+    std::ifstream infile(filename, std::ios::binary);
+    if (!infile.is_open()) {
+        std::cerr << "Unable to open file" << std::endl;
+        return nullptr;
+    }
+    std::vector<char> buffer;
+    infile.seekg(0, std::ios::end);
+    const std::streamoff fileSize = infile.tellg();
+    infile.seekg(0, std::ios::beg);
+    if (fileSize > 0)
+        buffer.reserve(fileSize);
+    while (infile) {
+        const size_t oldSize = buffer.size();
+        buffer.resize(oldSize + READ_BLOCK_SIZE);
+        infile.read(buffer.data() + oldSize, READ_BLOCK_SIZE);
+        buffer.resize(oldSize + infile.gcount());
+    }
+    infile.close();
+    return parseBuffer(buffer.data(), buffer.size(), numberOfThreads);
+}
+
+/**
+ * @brief Appends the next block of the file to the buffer.
+ *
+ * @return bool True if some bytes have been read, false at the end of the file.
+ */
+static bool readBlock(std::ifstream& infile, std::vector<char>& buffer) {
+    if (!infile) return false;
+    const size_t oldSize = buffer.size();
+    buffer.resize(oldSize + READ_BLOCK_SIZE);
+    infile.read(buffer.data() + oldSize, READ_BLOCK_SIZE);
+    buffer.resize(oldSize + infile.gcount());
+    return infile.gcount() > 0;
+}
+
+/**
+ * @brief Checks if the text contains a complete (newline terminated) line that is
+ * neither blank nor a comment, i.e. the complete header line.
+ */
+static bool containsHeaderLine(const char* position, const char* end) {
+    while (position < end) {
+        const char* lineEnd = findLineEnd(position, end);
+        if (lineEnd == end) return false;
+        if (!isRestOfLineEmpty(position, lineEnd)) return true;
+        position = lineEnd+1;
+    }
+    return false;
+}
+
+/**
+ * @brief Loads a graph from a file in the text edge list format, giving up as soon
+ * as the graph is known to have too many edges to be planar.
+ *
+ * The file is read and parsed one block at a time, counting the edges. If the
+ * graph has at least 3 nodes and more than 3n-6 edges are read, the reading
+ * stops there and no graph is built, since such a graph cannot be planar.
+ *
+ * @param filename The name of the input file.
+ * @param exceedsPlanarBound Output, set to true if the reading stopped because
+ *        of the edge bound, false otherwise.
+ * @return const Graph* Pointer to the loaded (compacted) graph, or nullptr if the
+ *         file cannot be opened, contains malformed lines or exceeds the edge bound.
+ */
+const Graph* GraphParser::parseFileWithPlanarBound(const std::string& filename, bool& exceedsPlanarBound) {
+    exceedsPlanarBound = false;
+    std::ifstream infile(filename, std::ios::binary);
+    if (!infile.is_open()) {
+        std::cerr << "Unable to open file" << std::endl;
+        return nullptr;
+    }
+    std::vector<char> buffer;
+    bool isEndOfFile = false;
+    while (!containsHeaderLine(buffer.data(), buffer.data() + buffer.size()) && !isEndOfFile)
+        isEndOfFile = !readBlock(infile, buffer);
+    int numberOfNodes{};
+    int headerLines{};
+    const char* bodyBegin = parseHeader(buffer.data(), buffer.data() + buffer.size(), numberOfNodes, headerLines);
+    if (bodyBegin == nullptr)
+        return nullptr;
+    const bool isBounded = numberOfNodes >= 3;
+    const size_t maxNumberOfEntries = isBounded ? 2*(3*size_t(numberOfNodes)-6) : 0;
+    std::vector<ParsedChunk> chunks(1);
+    ParsedChunk& chunk = chunks[0];
+    chunk.degrees_m.assign(numberOfNodes, 0);
+    size_t parsedSize = bodyBegin - buffer.data();
+    while (true) {
+        // parse the complete lines of the buffer (all of them at the end of the file)
+        const char* begin = buffer.data();
+        const char* position = begin + parsedSize;
+        const char* parseEnd = begin + buffer.size();
+        if (!isEndOfFile) {
+            while (parseEnd > position && parseEnd[-1] != '\n')
+                --parseEnd;
+        }
+        while (position < parseEnd) {
+            position = parseEdgeLine(position, parseEnd, numberOfNodes, chunk);
+            if (isBounded && chunk.edges_m.size() > maxNumberOfEntries) {
+                exceedsPlanarBound = true;
+                return nullptr;
+            }
+        }
+        if (isEndOfFile) break;
+        // keep only the last incomplete line
+        buffer.erase(buffer.begin(), buffer.begin() + (position - begin));
+        parsedSize = 0;
+        isEndOfFile = !readBlock(infile, buffer);
+    }
+    infile.close();
+    if (reportErrors(chunks, headerLines) > 0)
+        return nullptr;
+    return buildGraph(numberOfNodes, chunks);
+}
+
+/**
+ * @brief Parses a graph from a buffer holding text in the edge list format.
+ *
+ * The edge lines are split into at most numberOfThreads chunks, each parsed on
+ * its own thread. If threads are not available, the chunks are parsed by the
+ * calling thread.
+ *
+ * @param data Pointer to the first character of the buffer.
+ * @param size The number of characters of the buffer.
+ * @param numberOfThreads The maximum number of threads used for parsing.
+ * @return const Graph* Pointer to the parsed (compacted) graph, or nullptr if the
+ *         buffer contains malformed lines.
+ */
+const Graph* GraphParser::parseBuffer(const char* data, const size_t size, const int numberOfThreads) {
+    const char* end = data + size;
+    int numberOfNodes{};
+    int headerLines{};
+    const char* bodyBegin = parseHeader(data, end, numberOfNodes, headerLines);
+    if (bodyBegin == nullptr)
+        return nullptr;
+    // split the edge lines into chunks at line boundaries
+    const size_t bodySize = end - bodyBegin;
+    int numberOfChunks = numberOfThreads > 1 ? numberOfThreads : 1;
+    if (bodySize / numberOfChunks < MIN_CHUNK_SIZE)
+        numberOfChunks = bodySize / MIN_CHUNK_SIZE > 0 ? bodySize / MIN_CHUNK_SIZE : 1;
+    std::vector<ParsedChunk> chunks(numberOfChunks);
+    const char* chunkBegin = bodyBegin;
+    for (int i = 0; i < numberOfChunks; ++i) {
+        const char* chunkEnd = end;
+        if (i < numberOfChunks-1) {
+            chunkEnd = bodyBegin + bodySize * (i+1) / numberOfChunks;
+            if (chunkEnd < chunkBegin) chunkEnd = chunkBegin;
+            chunkEnd = findLineEnd(chunkEnd, end);
+            if (chunkEnd < end) ++chunkEnd;
+        }
+        chunks[i].begin_m = chunkBegin;
+        chunks[i].end_m = chunkEnd;
+        chunkBegin = chunkEnd;
+    }
+    // parse the chunks, the first one on the calling thread
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numberOfChunks; ++i) {
+        try {
+            threads.emplace_back(parseChunk, numberOfNodes, &chunks[i]);
+        } catch (const std::system_error&) {
+            break;
+        }
+    }
+    parseChunk(numberOfNodes, &chunks[0]);
+    for (int i = threads.size()+1; i < numberOfChunks; ++i)
+        parseChunk(numberOfNodes, &chunks[i]);
+    for (std::thread& thread : threads)
+        thread.join();
+    if (reportErrors(chunks, headerLines) > 0)
+        return nullptr;
+    return buildGraph(numberOfNodes, chunks);
+}
@@ -0,0 +1,35 @@
+#ifndef MY_GRAPH_PARSER_H
+#define MY_GRAPH_PARSER_H
+
+#include <cstddef>
+#include <string>
+
+#include "graph.hpp"
+
+/**
+ * @class GraphParser
+ * @brief Parser for graphs in the text edge list format.
+ *
+ * The format is a first line holding the number of nodes, followed by one edge
+ * per line given as two node indices separated by blanks. Blank lines and lines
+ * starting with "//" are ignored, and an edge may be followed by a "//" comment.
+ *
+ * The whole input is parsed into a flat edge list while counting node degrees,
+ * then the CSR arrays of the graph are allocated once and filled, keeping the
+ * neighbors of each node in the order in which its edges appear in the input.
+ * The input can be split into chunks (at line boundaries) parsed on separate
+ * threads. Every malformed line is reported with its line number and makes the
+ * parsing fail.
+ *
+ * parseFileWithPlanarBound is a streaming variant for planarity screening: it
+ * reads the file block by block and stops as soon as more than 3n-6 edges are
+ * read, without ever building the graph.
+ */
+class GraphParser {
+public:
+    static const Graph* parseFile(const std::string& filename, const int numberOfThreads = 1);
+    static const Graph* parseBuffer(const char* data, const size_t size, const int numberOfThreads = 1);
+    static const Graph* parseFileWithPlanarBound(const std::string& filename, bool& exceedsPlanarBound);
+};
+
+#endif
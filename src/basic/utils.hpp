@@ -2,6 +2,7 @@
 #define MY_UTILS_H
 
 #include <vector>
+#include <memory_resource>
 #include <iostream>
 #include <string>
 #include <algorithm>
@@ -86,7 +87,7 @@ void printArray(T array[], int size, const std::string& end = "\n") {
 template <typename T>
 class ArrayPointers {
 private:
-    std::vector<T*> pointers_m;
+    std::pmr::vector<T*> pointers_m;
 public:
     /**
      * @brief Constructs an ArrayPointers object with a specified number of pointers.
@@ -95,12 +96,10 @@ public:
      * size `numberOfPointers` and sets each element to `nullptr`.
      *
      * @param numberOfPointers The number of pointers to be managed by the ArrayPointers object.
+     * @param resource The memory resource the pointers are allocated from.
      */
-    ArrayPointers(const int numberOfPointers) {
-        pointers_m.resize(numberOfPointers);
-        for (int i = 0; i < numberOfPointers; ++i)
-            pointers_m[i] = nullptr;
-    }
+    ArrayPointers(const int numberOfPointers, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    : pointers_m(numberOfPointers, nullptr, resource) {}
 
     /**
      * @brief Retrieves a pointer from the pointers_m array at the specified index.
@@ -4,49 +4,98 @@
 #include <memory>
 
 #include "basic/graph.hpp"
+#include "basic/binaryGraph.hpp"
+#include "basic/graphParser.hpp"
 #include "auslander-parter/embedder.hpp"
+#include "auslander-parter/blockCutTree.hpp"
 #include "sefe/bicoloredGraph.hpp"
 #include "sefe/embedderSefe.hpp"
 #include "ogdf-drawers.hpp"
 
+int embedGraph(const Graph* graph, const bool computeWitness = false) {
+    if (graph == nullptr)
+        return -2;
+    std::unique_ptr<const Graph> graphPtr(graph);
+    if (!graph->isConnected()) {
+        std::cerr << "Graph is not connected." << std::endl;
+        return -1;
+    }
+    Embedder embedder(1, FIRST_FOUND_CYCLE, LEFT_RIGHT);
+    std::vector<std::pair<int, int>> witness{};
+    std::optional<const Embedding*> embedding = embedder.embedGraph(graph, computeWitness ? &witness : nullptr);
+    if (embedding.has_value()) {
+        std::unique_ptr<const Embedding> embeddingPtr(embedding.value());
+        drawEmbeddingToFile(embedding.value());
+        return 1;
+    }
+    if (computeWitness) {
+        // one edge of the K5 or K3,3 subdivision per line
+        std::string witnessString{};
+        for (const auto& [from, to] : witness)
+            witnessString += std::to_string(from) + " " + std::to_string(to) + "\n";
+        saveStringToFile("/kuratowski.txt", witnessString);
+    }
+    return 0;
+}
+
 extern "C" {
     int embedLoadedFile() {
-        const Graph* graph = Graph::loadFromFile("input.txt");
-        std::unique_ptr<const Graph> graphPtr(graph);
-        if (!graph->isConnected()) {
-            std::cerr << "Graph is not connected." << std::endl;
-            return -1;
-        }
-        Embedder embedder{};
-        std::optional<const Embedding*> embedding = embedder.embedGraph(graph);
-        if (embedding.has_value()) {
-            std::unique_ptr<const Embedding> embeddingPtr(embedding.value());
-            drawEmbeddingToFile(graph, embedding.value());
-            return 1;
-        }
-        return 0;
+        return embedGraph(Graph::loadFromFile("input.txt"));
+    }
+}
+
+// returns -3 if the file has been rejected while loading, having more than 3n-6 edges
+extern "C" {
+    int embedLoadedFileWithEdgeBound() {
+        bool exceedsPlanarBound = false;
+        const Graph* graph = GraphParser::parseFileWithPlanarBound("input.txt", exceedsPlanarBound);
+        if (exceedsPlanarBound)
+            return -3;
+        return embedGraph(graph);
+    }
+}
+
+// as embedLoadedFile, but if the graph is not planar writes a Kuratowski subdivision to /kuratowski.txt
+extern "C" {
+    int embedLoadedFileWithWitness() {
+        return embedGraph(Graph::loadFromFile("input.txt"), true);
+    }
+}
+
+extern "C" {
+    int embedLoadedBinaryFile() {
+        return embedGraph(BinaryGraph::loadFromFile("input.bin"));
+    }
+}
+
+extern "C" {
+    int convertLoadedFile() {
+        return BinaryGraph::convertTextFile("input.txt", "input.bin") ? 1 : 0;
     }
 }
 
+// returns -3 if either file could not be loaded
 extern "C" {
     int sefeLoadedFiles() {
         const Graph* red = Graph::loadFromFile("red.txt");
         const Graph* blue = Graph::loadFromFile("blue.txt");
         std::unique_ptr<const Graph> redPtr(red);
         std::unique_ptr<const Graph> bluePtr(blue);
+        if (red == nullptr || blue == nullptr)
+            return -3;
         if (red->size() != blue->size()) {
             std::cerr << "Error: graphs have different number of nodes." << std::endl;
             return -2;
         }
         const BicoloredGraph graph(red, blue);
         const Graph* intersection = graph.getIntersection();
-        BiconnectedComponentsHandler biconnectedComponentsHandler{intersection};
-        if (biconnectedComponentsHandler.size() > 1) {
+        const BlockCutTree intersectionTree(intersection);
+        if (!intersectionTree.isBiconnected()) {
             std::cerr << "Error: intersection graph is not biconnected." << std::endl;
             return -1;
         }
         EmbedderSefe embedder{};
-        std::optional<const EmbeddingSefe*> embedding = embedder.embedGraph(&graph);
+        std::optional<const EmbeddingSefe*> embedding = embedder.embedGraph(&graph, intersectionTree);
         if (!embedding.has_value())
             return 0;
         std::unique_ptr<const EmbeddingSefe> embeddingPtr(embedding.value());
@@ -7,60 +7,53 @@
 #include <ogdf/planarity/EmbedderModule.h>
 
 #include <memory>
+#include <vector>
+#include <cassert>
 
 #include "basic/utils.hpp"
+#include "auslander-parter/halfEdgeEmbedding.hpp"
 
-class AuslanderParterEmbedder : public ogdf::EmbedderModule {
-public:
-    void doCall(ogdf::Graph& graph, ogdf::adjEntry &adjExternal) {
-        const Graph* myGraph = OgdfUtils::ogdfGraphToMyGraph(&graph);
-        std::unique_ptr<const Graph> myGraphPtr(myGraph);
-        Embedder embedder;
-        std::optional<const Embedding*> embeddingOpt = embedder.embedGraph(myGraph);
-        if (!embeddingOpt) {
-            std::cout << "error\n";
-            exit(1);
-        }
-        const Embedding* embedding = embeddingOpt.value();
-        std::unique_ptr<const Embedding> embeddingPtr(embedding);
-        std::vector<int> position(embedding->size());
-        for (ogdf::node n : graph.nodes) {
-            const int index = n->index();
-            const Node* node = embedding->getNode(index);
-            const std::vector<const Node*>& neighbors = node->getNeighbors();
-            for (int i = 0; i < neighbors.size(); ++i)
-                position[neighbors[i]->getIndex()] = i;
-            std::vector<ogdf::adjEntry> order(neighbors.size());
-            for (ogdf::adjEntry& adj : n->adjEntries) {
-                const int neighbor = adj->twinNode()->index();
-                order[position[neighbor]] = adj;
-            }
-            ogdf::List<ogdf::adjEntry> newOrder;
-            for (ogdf::adjEntry& adj : order)
-                newOrder.pushBack(adj);
-            graph.sort(n, newOrder);
-        }
-    }
-};
+/**
+ * @brief Builds the OGDF graph of a half-edge embedding.
+ * 
+ * Node i is the i-th created node and edge e is the e-th created edge, directed
+ * from the tail to the head of dart 2e, so that every adjacency entry of the OGDF
+ * graph maps back to its dart in constant time.
+ * 
+ * @param halfEdges The half-edge embedding.
+ * @return ogdf::Graph* Pointer to the newly created OGDF graph.
+ */
+static ogdf::Graph* halfEdgesToOgdf(const HalfEdgeEmbedding* halfEdges) {
+    ogdf::Graph* graph = new ogdf::Graph();
+    std::vector<ogdf::node> nodes(halfEdges->size());
+    for (int i = 0; i < halfEdges->size(); ++i)
+        nodes[i] = graph->newNode();
+    for (int edge = 0; edge < halfEdges->numberOfEdges(); ++edge)
+        graph->newEdge(nodes[halfEdges->getTail(2*edge)], nodes[halfEdges->getHead(2*edge)]);
+    return graph;
+}
 
-class AuslanderParterEmbedderSefe : public ogdf::EmbedderModule {
+/**
+ * @class HalfEdgeEmbedderModule
+ * @brief OGDF embedder module applying the rotations of a half-edge embedding.
+ * 
+ * The module is called on a copy of the graph built by halfEdgesToOgdf, so the
+ * dart of an adjacency entry is given by its edge index and direction, and its
+ * position in the rotation is read directly from the half-edge embedding.
+ */
+class HalfEdgeEmbedderModule : public ogdf::EmbedderModule {
 private:
-    const Embedding* embedding_m;
+    const HalfEdgeEmbedding* halfEdges_m;
 public:
-    AuslanderParterEmbedderSefe(const Embedding* embedding) 
-    : embedding_m(embedding) {}
+    HalfEdgeEmbedderModule(const HalfEdgeEmbedding* halfEdges)
+    : halfEdges_m(halfEdges) {}
     void doCall(ogdf::Graph& graph, ogdf::adjEntry &adjExternal) {
-        std::vector<int> position(embedding_m->size());
         for (ogdf::node n : graph.nodes) {
-            const int index = n->index();
-            const Node* node = embedding_m->getNode(index);
-            const std::vector<const Node*>& neighbors = node->getNeighbors();
-            for (int i = 0; i < neighbors.size(); ++i)
-                position[neighbors[i]->getIndex()] = i;
-            std::vector<ogdf::adjEntry> order(neighbors.size());
+            std::vector<ogdf::adjEntry> order(n->degree());
             for (ogdf::adjEntry& adj : n->adjEntries) {
-                const int neighbor = adj->twinNode()->index();
-                order[position[neighbor]] = adj;
+                const int dart = 2*adj->theEdge()->index() + (adj->isSource() ? 0 : 1);
+                assert(halfEdges_m->getHead(dart) == adj->twinNode()->index());
+                order[halfEdges_m->getRotationPosition(dart)] = adj;
             }
             ogdf::List<ogdf::adjEntry> newOrder;
             for (ogdf::adjEntry& adj : order)
@@ -70,8 +63,9 @@ public:
     }
 };
 
-void drawEmbeddingToFile(const Graph* graph, const Embedding* embedding) {
-    std::unique_ptr<ogdf::Graph> ogdfGraph = std::unique_ptr<ogdf::Graph>(OgdfUtils::myGraphToOgdf(graph));
+void drawEmbeddingToFile(const Embedding* embedding) {
+    const HalfEdgeEmbedding halfEdges(embedding);
+    std::unique_ptr<ogdf::Graph> ogdfGraph = std::unique_ptr<ogdf::Graph>(halfEdgesToOgdf(&halfEdges));
     ogdf::GraphAttributes GA(*ogdfGraph, ogdf::GraphAttributes::nodeGraphics | ogdf::GraphAttributes::edgeGraphics |
                         ogdf::GraphAttributes::nodeLabel | ogdf::GraphAttributes::edgeStyle |
                         ogdf::GraphAttributes::nodeStyle | ogdf::GraphAttributes::edgeArrow);
@@ -84,7 +78,7 @@ void drawEmbeddingToFile(const Graph* graph, const Embedding* embedding) {
         GA.arrowType(e) = ogdf::EdgeArrow::None;
     }
     ogdf::PlanarDrawLayout layout;
-    layout.setEmbedder(new AuslanderParterEmbedder);
+    layout.setEmbedder(new HalfEdgeEmbedderModule(&halfEdges));
     layout.call(GA);
 
     std::ostringstream svgStream;
@@ -100,7 +94,8 @@ void drawEmbeddingToFile(const Graph* graph, const Embedding* embedding) {
 }
 
 void drawSefeEmbeddingToFile(const Embedding* embedding, const Graph* intersection, const std::string& color, const std::string& outputFilename) {
-    std::unique_ptr<ogdf::Graph> ogdfGraph = std::unique_ptr<ogdf::Graph>(OgdfUtils::myGraphToOgdf(embedding));
+    const HalfEdgeEmbedding halfEdges(embedding);
+    std::unique_ptr<ogdf::Graph> ogdfGraph = std::unique_ptr<ogdf::Graph>(halfEdgesToOgdf(&halfEdges));
     ogdf::GraphAttributes GA(*ogdfGraph, ogdf::GraphAttributes::nodeGraphics |
                             ogdf::GraphAttributes::edgeGraphics |
                             ogdf::GraphAttributes::nodeLabel | ogdf::GraphAttributes::edgeStyle |
@@ -121,7 +116,7 @@ void drawSefeEmbeddingToFile(const Embedding* embedding, const Graph* intersecti
     }
 
     ogdf::PlanarDrawLayout layout;
-    layout.setEmbedder(new AuslanderParterEmbedderSefe(embedding));
+    layout.setEmbedder(new HalfEdgeEmbedderModule(&halfEdges));
     layout.call(GA);
 
     std::ostringstream svgStream;
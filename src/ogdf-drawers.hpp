@@ -6,7 +6,7 @@
 #include "basic/graph.hpp"
 #include "auslander-parter/embedder.hpp"
 
-void drawEmbeddingToFile(const Graph* graph, const Embedding* embedding);
+void drawEmbeddingToFile(const Embedding* embedding);
 
 void drawSefeEmbeddingToFile(const Embedding* embedding, const Graph* intersection,
     const std::string& color, const std::string& outputFilename);
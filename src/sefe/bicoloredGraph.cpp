@@ -9,7 +9,7 @@
  * @param graph Pointer to the BicoloredGraph to which this node belongs.
  */
 NodeWithColors::NodeWithColors(const int index, const BicoloredGraph* graph)
-: index_m(index), graph_m(graph) {}
+: index_m(index), edges_m(graph->getMemoryResource()), graph_m(graph) {}
 
 /**
  * @brief Retrieves the index of the node.
@@ -23,30 +23,18 @@ const int NodeWithColors::getIndex() const {
     return index_m;
 }
 
-/**
- * @brief Retrieves the edges associated with the node (const version).
- * 
- * This function returns a constant reference to the vector of edges
- * that are connected to the node. Each edge in the vector represents
- * a connection to another node in the graph.
- * 
- * @return const std::vector<Edge>& A constant reference to the vector of edges.
- */
-const std::vector<Edge>& NodeWithColors::getEdges() const {
-    return edges_m;
-}
-
 /**
  * @brief Retrieves the edges associated with the node.
  * 
- * This function returns a reference to the vector of edges
- * that are connected to the node. Each edge in the vector represents
- * a connection to another node in the graph.
+ * This function returns a read-only range over the edges that are connected
+ * to the node. Each edge in the range represents a connection to another node
+ * in the graph.
  * 
- * @return std::vector<Edge>& A reference to the vector of edges.
+ * @return EdgesRange A read-only range of the edges of the node.
  */
-std::vector<Edge>& NodeWithColors::getEdges() {
-    return edges_m;
+EdgesRange NodeWithColors::getEdges() const {
+    const ColoredNeighbor* begin = edges_m.data();
+    return EdgesRange(begin, begin+edges_m.size(), graph_m->getNode(0));
 }
 
 /**
@@ -56,11 +44,13 @@ std::vector<Edge>& NodeWithColors::getEdges() {
  * assigning the specified color to the edge. It assumes that the edge does not already
  * exist in the graph.
  *
- * @param neighbor A pointer to the neighboring node to which the edge is added.
+ * @param neighbor A pointer to the neighboring node to which the edge is added. It must
+ *                 belong to the same graph.
  * @param color The color of the edge being added.
  */
 void NodeWithColors::addEdge(const NodeWithColors* neighbor, const Color color) {
-    edges_m.push_back(Edge{neighbor, color});
+    assert(neighbor->getBicoloredGraph() == graph_m);
+    edges_m.push_back(ColoredNeighbor{NodeIndex(neighbor->getIndex()), NodeIndex(color)});
     if (color == Color::BLACK)
         ++numberOfBlackEdges_m;
 }
@@ -90,13 +80,14 @@ const int NodeWithColors::getNumberOfBlackEdges() const {
 /**
  * @brief Constructs a BicoloredGraph from two input graphs.
  *
- * This constructor initializes a BicoloredGraph by taking two input graphs
- * and computing their intersection. It then iterates through the nodes and
- * edges of the input graphs to determine the color of the edges in the 
- * resulting BicoloredGraph. The edges are colored as follows:
+ * This constructor initializes a BicoloredGraph by merging the edges of two
+ * input graphs in O(n + m) time (see Graph::mergeEdges) and adding each edge
+ * of their union, with a color depending on which graphs contain it:
  * - BLACK if the edge exists in both input graphs.
  * - RED if the edge exists only in the first input graph.
  * - BLUE if the edge exists only in the second input graph.
+ * The BLACK edges form the intersection graph, which is compacted and indexed, so that edge membership queries on
+ * it (e.g. when coloring the drawing) take constant time.
  *
  * @param graph1 Pointer to the first input graph.
  * @param graph2 Pointer to the second input graph.
@@ -106,48 +97,33 @@ const int NodeWithColors::getNumberOfBlackEdges() const {
 BicoloredGraph::BicoloredGraph(const Graph* graph1, const Graph* graph2)
 : BicoloredGraph(graph1->size()) {
     assert(graph1->size() == graph2->size());
-    graph1->computeIntersection(graph2, &intersection_m);
-    bool isEdgeInGraph1[size()];
-    bool isEdgeInGraph2[size()];
-    for (int i = 0; i < size(); ++i) {
-        const Node* node1 = graph1->getNode(i);
-        const Node* node2 = graph2->getNode(i);
-        for (int j = 0; j < size(); ++j) {
-            isEdgeInGraph1[j] = false;
-            isEdgeInGraph2[j] = false;
-        }
-        for (const Node* neighbor : node1->getNeighbors())
-            isEdgeInGraph1[neighbor->getIndex()] = true;
-        for (const Node* neighbor : node2->getNeighbors())
-            isEdgeInGraph2[neighbor->getIndex()] = true;
-        for (int j = 0; j < size(); ++j) {
-            if (i > j) continue;
-            if (isEdgeInGraph1[j] && isEdgeInGraph2[j]) {
-                addEdge(i, j, Color::BLACK);
-                continue;
-            }
-            if (isEdgeInGraph1[j]) {
-                addEdge(i, j, Color::RED);
-                continue;
-            }
-            if (isEdgeInGraph2[j]) {
-                addEdge(i, j, Color::BLUE);
-                continue;
-            }
-        }
+    for (const MergedEdge& edge : graph1->mergeEdges(graph2)) {
+        if (edge.isInFirst && edge.isInSecond)
+            addEdge(edge.fromIndex, edge.toIndex, Color::BLACK);
+        else if (edge.isInFirst)
+            addEdge(edge.fromIndex, edge.toIndex, Color::RED);
+        else
+            addEdge(edge.fromIndex, edge.toIndex, Color::BLUE);
     }
+    intersection_m.compact();
+    intersection_m.buildEdgeIndex();
 }
 
 /**
  * @brief Constructs a BicoloredGraph with a specified number of nodes.
  *
- * @param numberOfNodes The number of nodes to be created in the graph. Must be greater than zero.
+ * @param numberOfNodes The number of nodes to be created in the graph. Must be greater than zero
+ *        and at most MAX_NUMBER_OF_BICOLORED_NODES.
+ * @param resource The memory resource the nodes and the edges are allocated from.
  */
-BicoloredGraph::BicoloredGraph(const int numberOfNodes)
-: intersection_m(numberOfNodes) {
+BicoloredGraph::BicoloredGraph(const int numberOfNodes, std::pmr::memory_resource* resource)
+: resource_m(resource), intersection_m(numberOfNodes, resource), nodes_m(resource), nodesPointers_m(resource) {
     assert(numberOfNodes > 0);
+    assert(numberOfNodes <= MAX_NUMBER_OF_BICOLORED_NODES);
+    nodes_m.reserve(numberOfNodes);
+    nodesPointers_m.reserve(numberOfNodes);
     for (int i = 0; i < numberOfNodes; ++i)
-        nodes_m.push_back(NodeWithColors(i, this));
+        nodes_m.emplace_back(i, this);
     for (int i = 0; i < numberOfNodes; ++i)
         nodesPointers_m.push_back(&nodes_m[i]);
     assert(nodes_m.size() == nodesPointers_m.size());
@@ -231,12 +207,21 @@ NodeWithColors* BicoloredGraph::getNode(const int index) {
  * This function returns a vector containing pointers to the nodes
  * with their associated colors in the BicoloredGraph.
  * 
- * @return std::vector<const NodeWithColors*> A vector of constant pointers to NodeWithColors.
+ * @return const std::pmr::vector<const NodeWithColors*>& A vector of constant pointers to NodeWithColors.
  */
-const std::vector<const NodeWithColors*> BicoloredGraph::getNodes() const {
+const std::pmr::vector<const NodeWithColors*>& BicoloredGraph::getNodes() const {
     return nodesPointers_m;
 }
 
+/**
+ * @brief Retrieves the memory resource the storage of the BicoloredGraph is allocated from.
+ * 
+ * @return std::pmr::memory_resource* Pointer to the memory resource.
+ */
+std::pmr::memory_resource* BicoloredGraph::getMemoryResource() const {
+    return resource_m;
+}
+
 /**
  * @brief Adds an edge between two nodes in the bicolored graph.
  *
@@ -307,7 +292,7 @@ std::string BicoloredGraph::toString() const {
     std::ostringstream result;
     for (auto& node : nodes_m) {
         const int index = node.getIndex();
-        const std::vector<Edge>& edges = node.getEdges();
+        const EdgesRange edges = node.getEdges();
         result << "node: " << index << " neighbors: " << edges.size() << " [ ";
         for (const Edge& edge : edges)
             result << "(" << edge.node->getIndex() << " " << color2string(edge.color) << ") ";
@@ -331,12 +316,13 @@ void BicoloredGraph::print() const {
  * and edges, ensuring that each edge is added only once based on the node indices.
  *
  * @param graph A pointer to the BicoloredGraph from which the subgraph is constructed.
+ * @param resource The memory resource the subgraph is allocated from.
  */
-BicoloredSubGraph::BicoloredSubGraph(const BicoloredGraph* graph)
-: BicoloredGraph(graph->size()), originalNodes_m(graph->size()), originalGraph_m(graph) {
+BicoloredSubGraph::BicoloredSubGraph(const BicoloredGraph* graph, std::pmr::memory_resource* resource)
+: BicoloredGraph(graph->size(), resource), originalGraph_m(graph), originalNodes_m(graph->size(), resource) {
     for (const NodeWithColors* node : graph->getNodes()) {
         setOriginalNode(getNode(node->getIndex()), node);
-        const std::vector<Edge>& edges = node->getEdges();
+        const EdgesRange edges = node->getEdges();
         for (const Edge& edge : edges) {
             const NodeWithColors* neighbor = edge.node;
             if (node->getIndex() < neighbor->getIndex()) continue;
@@ -353,9 +339,11 @@ BicoloredSubGraph::BicoloredSubGraph(const BicoloredGraph* graph)
  * 
  * @param numberOfNodes The number of nodes in the subgraph.
  * @param graph A pointer to the original BicoloredGraph from which this subgraph is derived.
+ * @param resource The memory resource the subgraph is allocated from.
  */
-BicoloredSubGraph::BicoloredSubGraph(const int numberOfNodes, const BicoloredGraph* graph)
-: BicoloredGraph(numberOfNodes), originalNodes_m(numberOfNodes), originalGraph_m(graph) {}
+BicoloredSubGraph::BicoloredSubGraph(const int numberOfNodes, const BicoloredGraph* graph,
+std::pmr::memory_resource* resource)
+: BicoloredGraph(numberOfNodes, resource), originalGraph_m(graph), originalNodes_m(numberOfNodes, resource) {}
 
 /**
  * @brief Retrieves the original node corresponding to the given node.
@@ -399,7 +387,7 @@ void BicoloredSubGraph::setOriginalNode(const NodeWithColors* node, const NodeWi
 void BicoloredSubGraph::print() const {
     for (const NodeWithColors* node : getNodes()) {
         const int originalIndex = getOriginalNode(node)->getIndex();
-        const std::vector<Edge>& edges = node->getEdges();
+        const EdgesRange edges = node->getEdges();
         std::cout << "node: " << originalIndex << " neighbors: " << edges.size() << " [ ";
         for (const Edge& edge : edges)
             std::cout << "(" << getOriginalNode(edge.node)->getIndex() << " " << color2string(edge.color) << ") ";
@@ -2,6 +2,8 @@
 #define MY_BICOLORED_GRAPH_H
 
 #include <vector>
+#include <memory_resource>
+#include <cstdint>
 #include <cassert>
 
 #include "../basic/utils.hpp"
@@ -12,9 +14,10 @@
  * @brief Represents the color of edges and attachments in a bicolored graph.
  * 
  * This enumeration defines the possible colors that an edge or an attachment
- * in a bicolored graph can have.
+ * in a bicolored graph can have. It is stored in a single byte, and its values
+ * fit in the COLOR_BITS bits of a ColoredNeighbor.
  */
-enum Color {
+enum Color : uint8_t {
     RED,
     BLUE,
     BLACK,
@@ -60,7 +63,33 @@ struct Edge {
     const Color color;
 };
 
+/**
+ * @brief The number of bits of a ColoredNeighbor storing the color of the edge.
+ */
+constexpr int COLOR_BITS = 3;
+
+/**
+ * @brief The maximum number of nodes of a bicolored graph.
+ */
+constexpr int64_t MAX_NUMBER_OF_BICOLORED_NODES = int64_t(1) << (32 - COLOR_BITS);
+
+/**
+ * @struct ColoredNeighbor
+ * @brief The record of an edge kept in the adjacency list of a node.
+ * 
+ * Stores the index of the neighbor (in the same graph) instead of a pointer, packed
+ * with the color of the edge into 32 bits, so that a record takes 4 bytes whatever
+ * the size of the graph, as long as it has at most MAX_NUMBER_OF_BICOLORED_NODES nodes.
+ */
+struct ColoredNeighbor {
+    NodeIndex index : 32 - COLOR_BITS;
+    NodeIndex color : COLOR_BITS;
+};
+static_assert(sizeof(ColoredNeighbor) == sizeof(NodeIndex), "ColoredNeighbor must take 32 bits");
+static_assert(Color::NONE < (1 << COLOR_BITS), "Color must fit in COLOR_BITS bits");
+
 class BicoloredGraph;
+class EdgesRange;
 
 /**
  * @class NodeWithColors
@@ -75,19 +104,74 @@ class BicoloredGraph;
 class NodeWithColors {
 private:
     const int index_m;
-    std::vector<Edge> edges_m;
+    std::pmr::vector<ColoredNeighbor> edges_m;
     const BicoloredGraph* graph_m;
     int numberOfBlackEdges_m = 0;
 public:
     NodeWithColors(const int index, const BicoloredGraph* graph);
     const int getIndex() const;
-    const std::vector<Edge>& getEdges() const;
-    std::vector<Edge>& getEdges();
+    EdgesRange getEdges() const;
     void addEdge(const NodeWithColors* neighbor, const Color color);
     const BicoloredGraph* getBicoloredGraph() const;
     const int getNumberOfBlackEdges() const;
 };
 
+/**
+ * @class EdgesRange
+ * @brief A read-only view over the edges of a node of a bicolored graph.
+ * 
+ * The range walks the adjacency records of the node and resolves each neighbor
+ * index to the corresponding node of the owning graph, so it can be used like
+ * a container of Edge values (range-for, size(), operator[]).
+ */
+class EdgesRange {
+private:
+    const ColoredNeighbor* begin_m;
+    const ColoredNeighbor* end_m;
+    const NodeWithColors* nodes_m;
+public:
+    /**
+     * @class Iterator
+     * @brief Forward iterator yielding the edges of the node.
+     */
+    class Iterator {
+    private:
+        const ColoredNeighbor* position_m;
+        const NodeWithColors* nodes_m;
+    public:
+        Iterator(const ColoredNeighbor* position, const NodeWithColors* nodes) : position_m(position), nodes_m(nodes) {}
+        Edge operator*() const { return Edge{nodes_m + position_m->index, Color(position_m->color)}; }
+        Iterator& operator++() { ++position_m; return *this; }
+        bool operator!=(const Iterator& other) const { return position_m != other.position_m; }
+        bool operator==(const Iterator& other) const { return position_m == other.position_m; }
+    };
+
+    /**
+     * @brief Constructs a range over the records in [begin, end).
+     * 
+     * @param begin Pointer to the first record.
+     * @param end Pointer past the last record.
+     * @param nodes Pointer to the first node of the graph owning the neighbors.
+     */
+    EdgesRange(const ColoredNeighbor* begin, const ColoredNeighbor* end, const NodeWithColors* nodes)
+    : begin_m(begin), end_m(end), nodes_m(nodes) {}
+    Iterator begin() const { return Iterator(begin_m, nodes_m); }
+    Iterator end() const { return Iterator(end_m, nodes_m); }
+    int size() const { return end_m - begin_m; }
+    bool empty() const { return begin_m == end_m; }
+
+    /**
+     * @brief Retrieves the edge at the given position of the range.
+     * 
+     * @param position The position of the edge in the range.
+     * @return Edge The edge, with a pointer to the neighboring node.
+     */
+    Edge operator[](const int position) const {
+        assert(position >= 0 && position < size());
+        return Edge{nodes_m + begin_m[position].index, Color(begin_m[position].color)};
+    }
+};
+
 /**
  * @class BicoloredGraph
  * @brief Represents a graph with nodes that can have two colors and supports operations on such graphs.
@@ -96,21 +180,27 @@ public:
  * between nodes with specified colors, retrieving nodes, and computing subgraphs based on colors.
  *
  * @note The graph is constructed using two other graphs or a specified number of nodes.
+ * The nodes, their edges and the intersection graph are allocated from the memory resource
+ * given at construction (the default heap unless stated otherwise), so that the subgraphs
+ * built during an embedding can be released together with their arena.
  */
 class BicoloredGraph {
 private:
+    std::pmr::memory_resource* resource_m;
     Graph intersection_m;
 protected:
-    std::vector<NodeWithColors> nodes_m;
-    std::vector<const NodeWithColors*> nodesPointers_m;
+    std::pmr::vector<NodeWithColors> nodes_m;
+    std::pmr::vector<const NodeWithColors*> nodesPointers_m;
 public:
     void addEdge(NodeWithColors* from, NodeWithColors* to, Color color);
     void addEdge(const int fromIndex, const int toIndex, Color color);
     BicoloredGraph(const Graph* graph1, const Graph* graph2);
-    BicoloredGraph(const int numberOfNodes);
+    BicoloredGraph(const int numberOfNodes,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     const NodeWithColors* getNode(const int index) const;
     NodeWithColors* getNode(const int index);
-    const std::vector<const NodeWithColors*> getNodes() const;
+    const std::pmr::vector<const NodeWithColors*>& getNodes() const;
+    std::pmr::memory_resource* getMemoryResource() const;
     const int size() const;
     virtual void print() const;
     const Graph* getIntersection() const;
@@ -139,8 +229,10 @@ private:
     const BicoloredGraph* originalGraph_m;
     ArrayPointers<const NodeWithColors> originalNodes_m;
 public:
-    BicoloredSubGraph(const int numberOfNodes, const BicoloredGraph* graph);
-    BicoloredSubGraph(const BicoloredGraph* graph);
+    BicoloredSubGraph(const int numberOfNodes, const BicoloredGraph* graph,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    BicoloredSubGraph(const BicoloredGraph* graph,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     const NodeWithColors* getOriginalNode(const NodeWithColors* node) const;
     void setOriginalNode(const NodeWithColors* node, const NodeWithColors* originalNode);
     void print() const override;
@@ -1,50 +1,163 @@
 #include "bicoloredSegment.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
 
 #include "../basic/utils.hpp"
 
-BicoloredSegment::BicoloredSegment(const int numberOfNodes, const BicoloredSubGraph* higherLevel, const IntersectionCycle* cycle)
-: BicoloredSubGraph(numberOfNodes, higherLevel->getOriginalGraph()), higherLevel_m(higherLevel),
-originalCycle_m(cycle), higherLevelNodesPointers_m(numberOfNodes) {
-    attachmentColor_m.resize(numberOfNodes);
-    for (int i = 0; i < numberOfNodes; ++i)
-        attachmentColor_m[i] = Color::NONE;
+BicoloredSegment::BicoloredSegment(const int numberOfNodes, const BicoloredSubGraph* higherLevel, const IntersectionCycle* cycle,
+std::pmr::memory_resource* resource)
+: BicoloredSubGraph(numberOfNodes, higherLevel->getOriginalGraph(), resource), attachmentNodes_m(resource),
+attachmentColor_m(numberOfNodes, Color::NONE, resource), higherLevel_m(higherLevel),
+originalCycle_m(cycle), higherLevelNodesPointers_m(numberOfNodes, resource) {}
+
+const BicoloredSegment* BicoloredSegmentsHandler::getSegment(const int index) const {
+    assert(!isChord(index));
+    return segments_m[index].get();
 }
 
-const BicoloredSegment* BicoloredSegmentsHandler::buildChord(const NodeWithColors* attachment1,
-const NodeWithColors* attachment2, const Color color) {
-    BicoloredSegment* chord = new BicoloredSegment(originalCycle_m->size(), higherLevel_m, originalCycle_m);
-    // assigning labels
-    // first nodes MUST be the same of the cycle in the SAME ORDER
-    for (int i = 0; i < originalCycle_m->size(); ++i) {
-        const NodeWithColors* oldNode = originalCycle_m->getNode(i);
-        const NodeWithColors* newNode = chord->getNode(i);
-        chord->setHigherLevelNode(newNode, oldNode);
-        const NodeWithColors* originalNode = higherLevel_m->getOriginalNode(oldNode);
-        chord->setOriginalNode(newNode, originalNode);
+bool BicoloredSegmentsHandler::isChord(const int index) const {
+    return index >= segments_m.size();
+}
+
+const BicoloredChord& BicoloredSegmentsHandler::getChord(const int index) const {
+    assert(isChord(index));
+    return chords_m[index-segments_m.size()];
+}
+
+// chords have 2 attachments
+int BicoloredSegmentsHandler::getNumberOfAttachments(const int index) const {
+    if (isChord(index)) return 2;
+    return segments_m[index]->getAttachments().size();
+}
+
+// attachments of a segment come in the order of getAttachments, the node index
+// of an attachment in the segment being its position in the cycle
+int BicoloredSegmentsHandler::getAttachmentPosition(const int index, const int attachmentIndex) const {
+    if (isChord(index)) {
+        const BicoloredChord& chord = getChord(index);
+        return attachmentIndex == 0 ? chord.from : chord.to;
     }
-    // adding cycle edges
-    for (int i = 0; i < originalCycle_m->size()-1; ++i)
-        chord->addEdge(i, i+1, Color::BLACK);
-    chord->addEdge(0, originalCycle_m->size()-1, Color::BLACK);
-    // adding chord edge
-    std::optional<int> fromIndex = originalCycle_m->getPositionOfNode(attachment1);
-    std::optional<int> toIndex = originalCycle_m->getPositionOfNode(attachment2);
-    assert(fromIndex);
-    assert(toIndex);
-    chord->addEdge(fromIndex.value(), toIndex.value(), color);
-    chord->addAttachment(chord->getNode(fromIndex.value()), color);
-    chord->addAttachment(chord->getNode(toIndex.value()), color);
-    return chord;
+    return segments_m[index]->getAttachments()[attachmentIndex]->getIndex();
 }
 
-const BicoloredSegment* BicoloredSegmentsHandler::getSegment(const int index) const {
-    return segments_m[index].get();
+// both attachments of a chord have the color of its edge
+Color BicoloredSegmentsHandler::getAttachmentColor(const int index, const int attachmentIndex) const {
+    if (isChord(index)) return getChord(index).color;
+    const BicoloredSegment* segment = segments_m[index].get();
+    return segment->getColorOfAttachment(segment->getAttachments()[attachmentIndex]);
+}
+
+// same as BicoloredSegment::isNodeAttachmentOfColor: black attachments are also red and blue
+bool BicoloredSegmentsHandler::isAttachmentOfColor(const int index, const int attachmentIndex, const Color color) const {
+    if (!isChord(index)) {
+        const BicoloredSegment* segment = segments_m[index].get();
+        return segment->isNodeAttachmentOfColor(segment->getAttachments()[attachmentIndex], color);
+    }
+    const Color chordColor = getChord(index).color;
+    switch (color) {
+        case Color::BLACK:
+            return chordColor == Color::BLACK;
+        case Color::RED:
+            return chordColor == Color::BLACK || chordColor == Color::RED_AND_BLUE || chordColor == Color::RED;
+        case Color::BLUE:
+            return chordColor == Color::BLACK || chordColor == Color::RED_AND_BLUE || chordColor == Color::BLUE;
+        default: assert(false);
+    }
+    return false;
+}
+
+// counting sort of the attachments by position in the cycle, in O(|C| + A) time for
+// A attachments in total
+void BicoloredSegmentsHandler::buildAttachmentsIndex() {
+    const int cycleSize = originalCycle_m->size();
+    attachedOffsets_m.assign(cycleSize+1, 0);
+    for (int i = 0; i < size(); ++i)
+        for (int k = 0; k < getNumberOfAttachments(i); ++k)
+            ++attachedOffsets_m[getAttachmentPosition(i, k)+1];
+    for (int position = 0; position < cycleSize; ++position)
+        attachedOffsets_m[position+1] += attachedOffsets_m[position];
+    attachedSegments_m.resize(attachedOffsets_m[cycleSize]);
+    std::vector<int> next(attachedOffsets_m.begin(), attachedOffsets_m.end()-1);
+    for (int i = 0; i < size(); ++i)
+        for (int k = 0; k < getNumberOfAttachments(i); ++k)
+            attachedSegments_m[next[getAttachmentPosition(i, k)]++] = i;
 }
 
-// computes a path between two attachments, assuring it does not go trought the cycle
+int BicoloredSegmentsHandler::getNumberOfSegmentsAttachedAt(const int cyclePosition) const {
+    return attachedOffsets_m[cyclePosition+1]-attachedOffsets_m[cyclePosition];
+}
+
+// the segments attached at a position come by increasing index
+int BicoloredSegmentsHandler::getSegmentAttachedAt(const int cyclePosition, const int k) const {
+    assert(k < getNumberOfSegmentsAttachedAt(cyclePosition));
+    return attachedSegments_m[attachedOffsets_m[cyclePosition]+k];
+}
+
+// computes the pairs of attachments joined by a path of black edges whose other nodes are
+// not in the cycle: first the pairs consecutive along the cycle among all the attachments,
+// then the pairs consecutive among the attachments reached by the same component of the
+// nodes out of the cycle (visited by black edges one component at a time)
+std::vector<std::pair<const NodeWithColors*, const NodeWithColors*>> BicoloredSegment::computeAttachmentsJoinedByBlackPaths() const {
+    const int numberOfAttachments = attachmentNodes_m.size();
+    std::vector<std::pair<const NodeWithColors*, const NodeWithColors*>> consecutivePairs{};
+    std::vector<std::pair<const NodeWithColors*, const NodeWithColors*>> otherPairs{};
+    // the attachments as positions in the cycle, and the next one of each along the cycle
+    std::vector<int> positions{};
+    for (const NodeWithColors* attachment : attachmentNodes_m)
+        positions.push_back(attachment->getIndex());
+    std::sort(positions.begin(), positions.end());
+    std::vector<int> nextAttachment(originalCycle_m->size(), -1);
+    for (int i = 0; i < numberOfAttachments; ++i)
+        nextAttachment[positions[i]] = positions[(i+1) % numberOfAttachments];
+    auto isCycleNode = [this](const NodeWithColors* node) {
+        return originalCycle_m->hasNode(getHigherLevelNode(node));
+    };
+    std::vector<int> componentOfNode(size(), -1);
+    // the last component reaching each attachment by a black edge
+    std::vector<int> componentOfAttachment(originalCycle_m->size(), -1);
+    for (const NodeWithColors* root : getNodes()) {
+        if (componentOfNode[root->getIndex()] != -1 || isCycleNode(root)) continue;
+        const int component = root->getIndex();
+        componentOfNode[root->getIndex()] = component;
+        std::vector<int> reached{};
+        std::list<const NodeWithColors*> queue{root};
+        while (queue.size() != 0) {
+            const NodeWithColors* node = queue.front();
+            queue.pop_front();
+            for (const Edge& edge : node->getEdges()) {
+                if (edge.color != Color::BLACK) continue;
+                const NodeWithColors* neighbor = edge.node;
+                if (isCycleNode(neighbor)) {
+                    if (componentOfAttachment[neighbor->getIndex()] == component) continue;
+                    componentOfAttachment[neighbor->getIndex()] = component;
+                    reached.push_back(neighbor->getIndex());
+                    continue;
+                }
+                if (componentOfNode[neighbor->getIndex()] == -1) {
+                    componentOfNode[neighbor->getIndex()] = component;
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+        if (reached.size() < 2) continue;
+        std::sort(reached.begin(), reached.end());
+        for (int i = 0; i < reached.size(); ++i) {
+            const int position = reached[i];
+            const int next = reached[(i+1) % reached.size()];
+            if (nextAttachment[position] == next)
+                consecutivePairs.push_back(std::make_pair(getNode(position), getNode(next)));
+            else if (reached.size() > 2 || i == 0)
+                otherPairs.push_back(std::make_pair(getNode(position), getNode(next)));
+        }
+    }
+    consecutivePairs.insert(consecutivePairs.end(), otherPairs.begin(), otherPairs.end());
+    return consecutivePairs;
+}
+
+// computes a path of black edges between two attachments, whose other nodes are not in the
+// cycle (so it does not go through a third attachment)
 std::list<const NodeWithColors*> BicoloredSegment::computeBlackPathBetweenAttachments(const NodeWithColors* start, const NodeWithColors* end) const {
     assert(isNodeAnAttachment(start));
     assert(isNodeAnAttachment(end));
@@ -57,6 +170,8 @@ std::list<const NodeWithColors*> BicoloredSegment::computeBlackPathBetweenAttach
         const NodeWithColors* node = queue.front();
         queue.pop_front();
         const NodeWithColors* higherLevelNode = getHigherLevelNode(node);
+        if (node != start && originalCycle_m->hasNode(higherLevelNode))
+            continue; // the path must not go through other attachments
         for (const Edge& edge : node->getEdges()) {
             if (edge.color != Color::BLACK) continue;
             const NodeWithColors* neighbor = edge.node;
@@ -71,6 +186,7 @@ std::list<const NodeWithColors*> BicoloredSegment::computeBlackPathBetweenAttach
         }
         if (prevOfNode[end->getIndex()] != nullptr) break;
     }
+    assert(prevOfNode[end->getIndex()] != nullptr);
     std::list<const NodeWithColors*> path{};
     const NodeWithColors* crawl = end;
     while (crawl != start) {
@@ -84,16 +200,23 @@ std::list<const NodeWithColors*> BicoloredSegment::computeBlackPathBetweenAttach
 void BicoloredSegmentsHandler::print() const {
     for (int i = 0; i < size(); ++i) {
         std::cout << "segment [" << i << "]\n";
+        if (isChord(i)) {
+            const BicoloredChord& chord = getChord(i);
+            std::cout << "chord: " << higherLevel_m->getOriginalNode(originalCycle_m->getNode(chord.from))->getIndex()
+                << " " << higherLevel_m->getOriginalNode(originalCycle_m->getNode(chord.to))->getIndex()
+                << " " << color2string(chord.color) << "\n";
+            continue;
+        }
         const BicoloredSegment* segment = getSegment(i);
         segment->print();
     }
 }
 
 int BicoloredSegmentsHandler::size() const {
-    return segments_m.size();
+    return segments_m.size()+chords_m.size();
 }
 
-const std::vector<const NodeWithColors*> BicoloredSegment::getAttachments() const {
+const std::pmr::vector<const NodeWithColors*>& BicoloredSegment::getAttachments() const {
     return attachmentNodes_m;
 }
 
@@ -220,7 +343,7 @@ void BicoloredSegment::print() const {
         const NodeWithColors* node = getNode(i);
         const NodeWithColors* original = getOriginalNode(node);
         const int index = original->getIndex();
-        const std::vector<Edge>& edges = node->getEdges();
+        const EdgesRange edges = node->getEdges();
         std::cout << "node: " << index << " neighbors: " << edges.size() << " [ ";
         for (const Edge& edge : edges) {
             const NodeWithColors* originalNeighbor = getOriginalNode(edge.node);
@@ -230,26 +353,60 @@ void BicoloredSegment::print() const {
     }
 }
 
-BicoloredSegmentsHandler::BicoloredSegmentsHandler(const BicoloredSubGraph* graph, const IntersectionCycle* cycle)
-: higherLevel_m(graph), originalCycle_m(cycle) {
+BicoloredSegmentsHandler::BicoloredSegmentsHandler(const BicoloredSubGraph* graph, const IntersectionCycle* cycle,
+std::pmr::memory_resource* resource)
+: originalCycle_m(cycle), higherLevel_m(graph), resource_m(resource) {
     findSegments();
     findChords();
+    buildAttachmentsIndex();
+}
+
+// segments of a cycle just changed with a path of its only segment (not a path, so the
+// previous cycle had no chords): every new chord has an endpoint on the path, so only
+// the nodes of the path are scanned for chords; the segments are searched again rather
+// than split from the old one along the path, since every node off the new cycle is
+// copied into a new segment anyway, which makes a split as costly as the linear search;
+// segments and chords come in the same order as from the other constructor
+BicoloredSegmentsHandler::BicoloredSegmentsHandler(const BicoloredSubGraph* graph, const IntersectionCycle* cycle,
+const std::list<const NodeWithColors*>& changedPath, std::pmr::memory_resource* resource)
+: originalCycle_m(cycle), higherLevel_m(graph), resource_m(resource) {
+    findSegments();
+    findChordsAroundPath(changedPath);
+    buildAttachmentsIndex();
 }
 
 void BicoloredSegmentsHandler::findChords() {
-    for (int i = 0; i < originalCycle_m->size(); ++i) {
-        const NodeWithColors* node = originalCycle_m->getNode(i);
-        for (const Edge& edge : node->getEdges()) {
-            const NodeWithColors* neighbor = edge.node;
-            if (node->getIndex() < neighbor->getIndex()) continue;
-            if (originalCycle_m->hasNode(neighbor))
-                if (neighbor->getIndex() != originalCycle_m->getPrevOfNode(node)->getIndex()
-                && neighbor->getIndex() != originalCycle_m->getNextOfNode(node)->getIndex()) {
-                    const BicoloredSegment* chord = buildChord(node, neighbor, edge.color);
-                    segments_m.push_back(std::unique_ptr<const BicoloredSegment>(chord));
-                }
-        }
+    for (int i = 0; i < originalCycle_m->size(); ++i)
+        findChordsOfNode(originalCycle_m->getNode(i));
+}
+
+// chords between node and the cycle nodes with a lower index
+void BicoloredSegmentsHandler::findChordsOfNode(const NodeWithColors* node) {
+    for (const Edge& edge : node->getEdges()) {
+        const NodeWithColors* neighbor = edge.node;
+        if (node->getIndex() < neighbor->getIndex()) continue;
+        if (originalCycle_m->hasNode(neighbor))
+            if (neighbor->getIndex() != originalCycle_m->getPrevOfNode(node)->getIndex()
+            && neighbor->getIndex() != originalCycle_m->getNextOfNode(node)->getIndex())
+                chords_m.push_back(BicoloredChord{originalCycle_m->getPositionOfNode(node).value(),
+                    originalCycle_m->getPositionOfNode(neighbor).value(), edge.color});
+    }
+}
+
+// scans the nodes of the path (endpoints included) and their cycle neighbors with a higher
+// index, in the order of the cycle
+void BicoloredSegmentsHandler::findChordsAroundPath(const std::list<const NodeWithColors*>& path) {
+    std::vector<int> positions{};
+    for (const NodeWithColors* node : path) {
+        positions.push_back(originalCycle_m->getPositionOfNode(node).value());
+        for (const Edge& edge : node->getEdges())
+            if (node->getIndex() < edge.node->getIndex() && originalCycle_m->hasNode(edge.node))
+                positions.push_back(originalCycle_m->getPositionOfNode(edge.node).value());
     }
+    std::sort(positions.begin(), positions.end());
+    positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    for (int position : positions)
+        findChordsOfNode(originalCycle_m->getNode(position));
 }
 
 void BicoloredSegmentsHandler::findSegments() {
@@ -296,7 +453,7 @@ std::vector<std::pair<const NodeWithColors*, const Edge>>& edgesInSegment) {
 // edges vector does NOT contain cycle edges
 const BicoloredSegment* BicoloredSegmentsHandler::buildSegment(std::vector<const NodeWithColors*>& nodes,
 std::vector<std::pair<const NodeWithColors*, const Edge>>& edges) {
-    BicoloredSegment* segment = new BicoloredSegment(nodes.size()+originalCycle_m->size(), higherLevel_m, originalCycle_m);
+    BicoloredSegment* segment = new BicoloredSegment(nodes.size()+originalCycle_m->size(), higherLevel_m, originalCycle_m, resource_m);
     // first nodes MUST be the same of the cycle in the SAME ORDER
     int oldToNewLabel[higherLevel_m->size()];
     // adding cycle nodes (which means setting up the pointers)
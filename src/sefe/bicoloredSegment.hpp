@@ -5,28 +5,33 @@
 #include <utility>
 #include <list>
 #include <memory>
+#include <memory_resource>
 
 #include "intersectionCycle.hpp"
 #include "bicoloredGraph.hpp"
 
+// like Segment, a bicolored segment is a copy of the whole cycle followed by the nodes of
+// the segment, not a view over the storage of the graph it comes from
 class BicoloredSegment : public BicoloredSubGraph {
 private:
-    std::vector<const NodeWithColors*> attachmentNodes_m{};
-    std::vector<Color> attachmentColor_m{};
+    std::pmr::vector<const NodeWithColors*> attachmentNodes_m;
+    std::pmr::vector<Color> attachmentColor_m;
     const BicoloredSubGraph* higherLevel_m;
     const IntersectionCycle* originalCycle_m;
     ArrayPointers<const NodeWithColors> higherLevelNodesPointers_m;
 public:
-    BicoloredSegment(const int numberOfNodes, const BicoloredSubGraph* higherLevel, const IntersectionCycle* cycle);
+    BicoloredSegment(const int numberOfNodes, const BicoloredSubGraph* higherLevel, const IntersectionCycle* cycle,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     bool isBlackPath() const;
     bool isPath() const;
-    const std::vector<const NodeWithColors*> getAttachments() const;
+    const std::pmr::vector<const NodeWithColors*>& getAttachments() const;
     void addAttachment(const NodeWithColors* attachment, const Color color);
     bool isNodeAnAttachment(const NodeWithColors* node) const;
     bool isNodeRedAttachment(const NodeWithColors* node) const;
     bool isNodeBlueAttachment(const NodeWithColors* node) const;
     bool isNodeBlackAttachment(const NodeWithColors* node) const;
     bool isNodeAttachmentOfColor(const NodeWithColors* node, const Color color) const;
+    std::vector<std::pair<const NodeWithColors*, const NodeWithColors*>> computeAttachmentsJoinedByBlackPaths() const;
     std::list<const NodeWithColors*> computeBlackPathBetweenAttachments(const NodeWithColors* start,
         const NodeWithColors* end) const;
     const IntersectionCycle* getOriginalCycle() const;
@@ -37,23 +42,53 @@ public:
     const Color getColorOfAttachment(const NodeWithColors* attachment) const;
 };
 
+// a chord of the cycle, as the positions in the cycle of its endpoints (from is the
+// endpoint with the higher node index) and the color of its edge
+struct BicoloredChord {
+    int from;
+    int to;
+    Color color;
+};
+
+// chords are stored as BicoloredChord records, with no subgraph: the indices of the
+// handler list the segments first and then the chords, and the attachments of both
+// are available as positions in the cycle; the segments attached at each position of
+// the cycle are indexed once the segments are found
 class BicoloredSegmentsHandler {
 private:
     std::vector<std::unique_ptr<const BicoloredSegment>> segments_m{};
+    std::vector<BicoloredChord> chords_m{};
     const IntersectionCycle* originalCycle_m;
     const BicoloredSubGraph* higherLevel_m;
+    std::pmr::memory_resource* resource_m;
+    // segments attached at each position of the cycle, by increasing index
+    std::vector<int> attachedOffsets_m{};
+    std::vector<int> attachedSegments_m{};
     const BicoloredSegment* buildSegment(std::vector<const NodeWithColors*>& nodes,
         std::vector<std::pair<const NodeWithColors*, const Edge>>& edges);
-    const BicoloredSegment* buildChord(const NodeWithColors* attachment1,
-        const NodeWithColors* attachment2, const Color color);
     void dfsFindSegments(const NodeWithColors* node, bool isNodeVisited[],
         std::vector<const NodeWithColors*>& nodesInSegment,
         std::vector<std::pair<const NodeWithColors*, const Edge>>& edgesInSegment);
     void findSegments();
     void findChords();
+    void findChordsOfNode(const NodeWithColors* node);
+    void findChordsAroundPath(const std::list<const NodeWithColors*>& path);
+    void buildAttachmentsIndex();
 public:
-    BicoloredSegmentsHandler(const BicoloredSubGraph* graph, const IntersectionCycle* cycle);
+    BicoloredSegmentsHandler(const BicoloredSubGraph* graph, const IntersectionCycle* cycle,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    BicoloredSegmentsHandler(const BicoloredSubGraph* graph, const IntersectionCycle* cycle,
+        const std::list<const NodeWithColors*>& changedPath,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     const BicoloredSegment* getSegment(const int index) const;
+    bool isChord(const int index) const;
+    const BicoloredChord& getChord(const int index) const;
+    int getNumberOfAttachments(const int index) const;
+    int getAttachmentPosition(const int index, const int attachmentIndex) const;
+    Color getAttachmentColor(const int index, const int attachmentIndex) const;
+    bool isAttachmentOfColor(const int index, const int attachmentIndex, const Color color) const;
+    int getNumberOfSegmentsAttachedAt(const int cyclePosition) const;
+    int getSegmentAttachedAt(const int cyclePosition, const int k) const;
     int size() const;
     void print() const;
 };
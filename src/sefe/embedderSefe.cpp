@@ -2,16 +2,18 @@
 
 #include <iostream>
 #include <cassert>
+#include <algorithm>
+#include <tuple>
 #include <vector>
 
-#include "../auslander-parter/biconnectedComponent.hpp"
+#include "../auslander-parter/blockCutTree.hpp"
 #include "bicoloredGraph.hpp"
 #include "bicoloredSegment.hpp"
 #include "interlacementSefe.hpp"
 #include "intersectionCycle.hpp"
 
-EmbeddingSefe::EmbeddingSefe(const BicoloredSubGraph* originalGraph)
-: BicoloredSubGraph(originalGraph->size(), originalGraph) {
+EmbeddingSefe::EmbeddingSefe(const BicoloredSubGraph* originalGraph, std::pmr::memory_resource* resource)
+: BicoloredSubGraph(originalGraph->size(), originalGraph, resource) {
     for (int i = 0; i < size(); ++i) {
         const NodeWithColors* node = originalGraph->getNode(i);
         const NodeWithColors* originalNode = originalGraph->getOriginalNode(node);
@@ -19,8 +21,8 @@ EmbeddingSefe::EmbeddingSefe(const BicoloredSubGraph* originalGraph)
     }
 }
 
-EmbeddingSefe::EmbeddingSefe(const BicoloredGraph* originalGraph)
-: BicoloredSubGraph(originalGraph->size(), originalGraph) {
+EmbeddingSefe::EmbeddingSefe(const BicoloredGraph* originalGraph, std::pmr::memory_resource* resource)
+: BicoloredSubGraph(originalGraph->size(), originalGraph, resource) {
     for (int i = 0; i < size(); ++i)
         setOriginalNode(getNode(i), originalGraph->getNode(i));
 }
@@ -57,83 +59,105 @@ const Embedding* EmbeddingSefe::computeBlueEmbedding(const Graph* blue) const {
     return embedding;
 }
 
-bool EmbedderSefe::testSefe(const Graph* graph1, const Graph* graph2) const {
+// if counters is not null, it is filled with the counters of the recursion of the call
+bool EmbedderSefe::testSefe(const Graph* graph1, const Graph* graph2, RecursionCounters* counters) const {
     BicoloredGraph bicoloredGraph(graph1, graph2);
-    const Graph* intersection = bicoloredGraph.getIntersection();
-    BiconnectedComponentsHandler bicCompHandler(intersection);
-    if (bicCompHandler.size() > 1) {
+    const BlockCutTree intersectionTree(bicoloredGraph.getIntersection());
+    return testSefe(&bicoloredGraph, intersectionTree, counters);
+}
+
+// intersectionTree must be the block-cut tree of the intersection of graph
+bool EmbedderSefe::testSefe(const BicoloredGraph* graph, const BlockCutTree& intersectionTree,
+RecursionCounters* counters) const {
+    assert(intersectionTree.getGraph() == graph->getIntersection());
+    if (counters != nullptr) *counters = RecursionCounters{};
+    if (!intersectionTree.isBiconnected()) {
         std::cout << "intersection must be biconnected\n";
         return false;
     }
-    BicoloredSubGraph bicoloredSubGraph(&bicoloredGraph);
+    std::pmr::monotonic_buffer_resource arena;
+    BicoloredSubGraph bicoloredSubGraph(graph, &arena);
     IntersectionCycle cycle(&bicoloredSubGraph);
-    return testSefe(&bicoloredSubGraph, &cycle);
+    RecursionCounters callCounters{};
+    const bool hasSefe = testSefe(&bicoloredSubGraph, &cycle, 1, callCounters);
+    if (counters != nullptr) *counters = callCounters;
+    return hasSefe;
 }
 
 // assumes intersection is biconnected
-bool EmbedderSefe::testSefe(const BicoloredSubGraph* bicoloredGraph, IntersectionCycle* cycle) const {
-    const BicoloredSegmentsHandler segmentsHandler = BicoloredSegmentsHandler(bicoloredGraph, cycle);
-    if (segmentsHandler.size() == 0) // entire biconnected component is a cycle
-        return true;
-    if (segmentsHandler.size() == 1) {
-        const BicoloredSegment* segment = segmentsHandler.getSegment(0);
-        if (segment->isPath())
-            return true;
-        // chosen cycle is bad
-        makeCycleGood(cycle, segment);
-        return testSefe(bicoloredGraph, cycle);
+bool EmbedderSefe::testSefe(const BicoloredSubGraph* bicoloredGraph, IntersectionCycle* cycle, const int depth,
+RecursionCounters& counters) const {
+    counters.recordDepth(depth);
+    // the segments are only needed until they are tested
+    std::pmr::monotonic_buffer_resource arena;
+    BicoloredSegmentsHandler segmentsHandler(bicoloredGraph, cycle, &arena);
+    if (segmentsHandler.size() == 1 && !segmentsHandler.isChord(0) && !segmentsHandler.getSegment(0)->isPath()) {
+        // chosen cycle is bad, the segments are updated around the new path of the cycle
+        segmentsHandler = makeCycleGood(bicoloredGraph, cycle, segmentsHandler, &arena);
+        counters.recordCycleRepair();
     }
+    if (segmentsHandler.size() <= 1) // entire biconnected component is a cycle, or the only segment is a path
+        return true;
     InterlacementGraphSefe interlacementGraph(cycle, &segmentsHandler);
     std::optional<std::vector<int>> bipartition = interlacementGraph.computeBipartition();
     if (!bipartition) return false;
     for (int i = 0; i < segmentsHandler.size(); ++i) {
+        if (segmentsHandler.isChord(i)) continue; // nothing to test
         const BicoloredSegment* segment = segmentsHandler.getSegment(i);
         IntersectionCycle cycle(segment);
-        if (!testSefe(segment, &cycle)) return false;
+        if (!testSefe(segment, &cycle, depth+1, counters)) return false;
     }
     return true;
 }
 
 // it may happen that a cycle induces only one segment, which is not a base case
-// so the cycle must be recomputed such that it ensures at least two segments
-void EmbedderSefe::makeCycleGood(IntersectionCycle* cycle, const BicoloredSegment* segment) const {
+// so the cycle must be recomputed such that it ensures at least two segments: a black
+// path of the segment between two attachments replaces one of the two parts of the cycle
+// between them. if the two attachments are consecutive along the cycle, replacing the part
+// with no other attachment always works, since it becomes a segment on its own (as in
+// Embedder::makeCycleGood); otherwise both parts are tried for the pairs consecutive among
+// the attachments of a black component, each new cycle being kept only if its segments
+// are not a single one that is not a path. if no candidate works, the program fails rather
+// than giving an answer without a proof;
+// returns the segments of the new cycle, found around the path now in the cycle
+BicoloredSegmentsHandler EmbedderSefe::makeCycleGood(const BicoloredSubGraph* graph, IntersectionCycle* cycle,
+const BicoloredSegmentsHandler& segmentsHandler, std::pmr::memory_resource* resource) const {
+    const BicoloredSegment* segment = segmentsHandler.getSegment(0);
     assert(!segment->isPath());
-    bool isCycleNodeAttachment[cycle->size()];
-    for (int i = 0; i < cycle->size(); ++i)
-        isCycleNodeAttachment[i] = false;
-    for (const NodeWithColors* attachment : segment->getAttachments()) {
-        const NodeWithColors* attachmentHigherLevel = segment->getHigherLevelNode(attachment);
-        isCycleNodeAttachment[cycle->getPositionOfNode(attachmentHigherLevel).value()] = true;
-    }
-    int foundAttachments = 0;
-    const NodeWithColors* attachmentsToUse[2];
-    const NodeWithColors* attachmentToInclude = nullptr;
-    for (int i = 0; i < cycle->size(); ++i) {
-        if (!isCycleNodeAttachment[i]) continue;
-        const NodeWithColors* node = cycle->getNode(i);
-        const NodeWithColors* nodeSegment = segment->getNode(i);
-        assert(segment->getHigherLevelNode(nodeSegment) == node);
-        if (!segment->isNodeBlackAttachment(nodeSegment)) {
-            attachmentToInclude = nodeSegment;
-            continue;
+    const auto candidates = segment->computeAttachmentsJoinedByBlackPaths();
+    assert(!candidates.empty());
+    auto toHigherLevel = [segment](const std::list<const NodeWithColors*>& path) {
+        std::list<const NodeWithColors*> pathHigherLevel;
+        for (const NodeWithColors* node : path)
+            pathHigherLevel.push_back(segment->getHigherLevelNode(node));
+        return pathHigherLevel;
+    };
+    auto isGood = [](const BicoloredSegmentsHandler& handler) {
+        return handler.size() != 1 || handler.isChord(0) || handler.getSegment(0)->isPath();
+    };
+    // the segments of the trial cycles are only counted, so they live in their own arena
+    std::pmr::monotonic_buffer_resource trialArena;
+    for (const auto& [start, end] : candidates) {
+        const std::list<const NodeWithColors*> path = toHigherLevel(segment->computeBlackPathBetweenAttachments(start, end));
+        // changeWithPath keeps the part of the cycle going from the last node of the path to the first one
+        for (const bool isReversed : {false, true}) {
+            std::list<const NodeWithColors*> orientedPath(path);
+            if (isReversed) orientedPath.reverse();
+            IntersectionCycle trialCycle(*cycle);
+            trialCycle.changeWithPath(orientedPath, nullptr);
+            if (!isGood(BicoloredSegmentsHandler(graph, &trialCycle, orientedPath, &trialArena))) continue;
+            *cycle = trialCycle;
+            return BicoloredSegmentsHandler(graph, cycle, orientedPath, resource);
         }
-        if (foundAttachments < 2)
-            attachmentsToUse[foundAttachments++] = nodeSegment;
-        else
-            attachmentToInclude = nodeSegment;
-        if (foundAttachments == 2 && attachmentToInclude != nullptr) break;
     }
-    std::list<const NodeWithColors*> path = segment->computeBlackPathBetweenAttachments(attachmentsToUse[0], attachmentsToUse[1]);
-    std::list<const NodeWithColors*> pathHigherLevel;
-    for (const NodeWithColors* node : path)
-        pathHigherLevel.push_back(segment->getHigherLevelNode(node));
-    if (attachmentToInclude != nullptr) attachmentToInclude = segment->getHigherLevelNode(attachmentToInclude);
-    cycle->changeWithPath(pathHigherLevel, attachmentToInclude);
+    std::cerr << "error: no black path of the segment makes the cycle separating\n";
+    exit(1);
 }
 
 // base case: biconnected component is a cycle
-const EmbeddingSefe* EmbedderSefe::baseCaseCycle(const BicoloredSubGraph* cycle) const {
-    EmbeddingSefe* embedding = new EmbeddingSefe(cycle);
+const EmbeddingSefe* EmbedderSefe::baseCaseCycle(const BicoloredSubGraph* cycle,
+std::pmr::memory_resource* resource) const {
+    EmbeddingSefe* embedding = new EmbeddingSefe(cycle, resource);
     for (int i = 0; i < cycle->size()-1; ++i)
         for (const Edge& edge : cycle->getNode(i)->getEdges())
             if (i < edge.node->getIndex())
@@ -141,40 +165,48 @@ const EmbeddingSefe* EmbedderSefe::baseCaseCycle(const BicoloredSubGraph* cycle)
     return embedding;
 }
 
-std::optional<const EmbeddingSefe*> EmbedderSefe::embedGraph(const BicoloredSubGraph* graph,
-IntersectionCycle* cycle) const {
-    const BicoloredSegmentsHandler segmentsHandler(graph, cycle);
-    if (segmentsHandler.size() == 0) // entire biconnected component is a cycle
-        return baseCaseCycle(graph);
-    if (segmentsHandler.size() == 1) {
-        const BicoloredSegment* segment = segmentsHandler.getSegment(0);
-        if (segment->isPath())
-            return baseCasePath(graph, cycle);
-        // chosen cycle is bad
-        makeCycleGood(cycle, segment);
-        return embedGraph(graph, cycle);
+std::optional<const EmbeddingSefe*> EmbedderSefe::embedGraph(const BicoloredSubGraph* graph, IntersectionCycle* cycle,
+std::pmr::memory_resource* resource, const int depth, RecursionCounters& counters) const {
+    counters.recordDepth(depth);
+    // the segments and their embeddings are only needed until they are merged
+    std::pmr::monotonic_buffer_resource arena;
+    BicoloredSegmentsHandler segmentsHandler(graph, cycle, &arena);
+    if (segmentsHandler.size() == 1 && !segmentsHandler.isChord(0) && !segmentsHandler.getSegment(0)->isPath()) {
+        // chosen cycle is bad, the segments are updated around the new path of the cycle
+        segmentsHandler = makeCycleGood(graph, cycle, segmentsHandler, &arena);
+        counters.recordCycleRepair();
     }
+    if (segmentsHandler.size() == 0) // entire biconnected component is a cycle
+        return baseCaseCycle(graph, resource);
+    if (segmentsHandler.size() == 1) // the only segment is a path (or a chord)
+        return baseCasePath(graph, cycle, resource);
     InterlacementGraphSefe interlacementGraph(cycle, &segmentsHandler);
     std::optional<std::vector<int>> bipartition = interlacementGraph.computeBipartition();
     if (!bipartition) return std::nullopt;
     std::vector<std::unique_ptr<const EmbeddingSefe>> embeddings{};
     for (int i = 0; i < segmentsHandler.size(); ++i) {
+        if (segmentsHandler.isChord(i)) { // nothing to embed
+            embeddings.push_back(nullptr);
+            continue;
+        }
         const BicoloredSegment* segment = segmentsHandler.getSegment(i);
-        std::optional<const EmbeddingSefe*> embedding = embedGraph(segment);
+        std::optional<const EmbeddingSefe*> embedding = embedGraph(segment, &arena, depth+1, counters);
         if (!embedding.has_value())
             return std::nullopt;
         embeddings.push_back(std::unique_ptr<const EmbeddingSefe>(embedding.value()));
     }
-    const EmbeddingSefe* embedding = mergeSegmentsEmbeddings(graph, cycle, embeddings, segmentsHandler, bipartition.value());
+    const EmbeddingSefe* embedding = mergeSegmentsEmbeddings(graph, cycle, embeddings, segmentsHandler,
+        bipartition.value(), resource);
     return embedding;
 }
 
 // base case: segment is a path
-const EmbeddingSefe* EmbedderSefe::baseCasePath(const BicoloredSubGraph* component, const IntersectionCycle* cycle) const {
-    EmbeddingSefe* embedding = new EmbeddingSefe(component);
+const EmbeddingSefe* EmbedderSefe::baseCasePath(const BicoloredSubGraph* component, const IntersectionCycle* cycle,
+std::pmr::memory_resource* resource) const {
+    EmbeddingSefe* embedding = new EmbeddingSefe(component, resource);
     for (int nodeIndex = 0; nodeIndex < component->size(); ++nodeIndex) {
         const NodeWithColors* node = component->getNode(nodeIndex);
-        const std::vector<Edge>& edges = node->getEdges();
+        const EdgesRange edges = node->getEdges();
         if (edges.size() == 2) { // attachment nodes will be handled later
             embedding->addSingleEdge(node->getIndex(), edges[0].node->getIndex(), edges[0].color);
             embedding->addSingleEdge(node->getIndex(), edges[1].node->getIndex(), edges[1].color);
@@ -212,9 +244,10 @@ const EmbeddingSefe* EmbedderSefe::baseCasePath(const BicoloredSubGraph* compone
     return embedding;
 }
 
-std::optional<const EmbeddingSefe*> EmbedderSefe::embedGraph(const BicoloredSubGraph* graph) const {
+std::optional<const EmbeddingSefe*> EmbedderSefe::embedGraph(const BicoloredSubGraph* graph,
+std::pmr::memory_resource* resource, const int depth, RecursionCounters& counters) const {
     IntersectionCycle cycle(graph);
-    return embedGraph(graph, &cycle);
+    return embedGraph(graph, &cycle, resource, depth, counters);
 }
 
 // base case: graph has <4 nodes
@@ -228,32 +261,57 @@ const EmbeddingSefe* EmbedderSefe::baseCaseGraph(const BicoloredGraph* graph) co
     return embedding;
 }
 
-std::optional<const EmbeddingSefe*> EmbedderSefe::embedGraph(const BicoloredGraph* graph) const {
+// if counters is not null, it is filled with the counters of the recursion of the call
+std::optional<const EmbeddingSefe*> EmbedderSefe::embedGraph(const BicoloredGraph* graph, RecursionCounters* counters) const {
+    if (counters != nullptr) *counters = RecursionCounters{};
+    if (graph->size() < 4) return baseCaseGraph(graph);
+    const BlockCutTree intersectionTree(graph->getIntersection());
+    return embedGraph(graph, intersectionTree, counters);
+}
+
+// intersectionTree must be the block-cut tree of the intersection of graph
+std::optional<const EmbeddingSefe*> EmbedderSefe::embedGraph(const BicoloredGraph* graph,
+const BlockCutTree& intersectionTree, RecursionCounters* counters) const {
+    assert(intersectionTree.getGraph() == graph->getIntersection());
+    if (counters != nullptr) *counters = RecursionCounters{};
     if (graph->size() < 4) return baseCaseGraph(graph);
-    const Graph* intersection = graph->getIntersection();
-    BiconnectedComponentsHandler bch(intersection);
-    if (bch.size() > 1) {
+    if (!intersectionTree.isBiconnected()) {
         std::cout << "intersection must be biconnected\n";
         return std::nullopt;
     }
-    const BicoloredSubGraph sGraph(graph);
-    return embedGraph(&sGraph);
+    std::pmr::monotonic_buffer_resource arena;
+    const BicoloredSubGraph sGraph(graph, &arena);
+    RecursionCounters callCounters{};
+    std::optional<const EmbeddingSefe*> embedding = embedGraph(&sGraph, &arena, 1, callCounters);
+    if (counters != nullptr) *counters = callCounters;
+    if (!embedding.has_value()) return std::nullopt;
+    std::unique_ptr<const EmbeddingSefe> embeddingPtr(embedding.value());
+    return copyEmbedding(graph, embeddingPtr.get());
+}
+
+// copies an embedding allocated from an arena to the default heap, keeping the order of the edges
+const EmbeddingSefe* EmbedderSefe::copyEmbedding(const BicoloredGraph* graph, const EmbeddingSefe* embedding) const {
+    EmbeddingSefe* output = new EmbeddingSefe(graph);
+    for (const NodeWithColors* node : embedding->getNodes())
+        for (const Edge& edge : node->getEdges())
+            output->addSingleEdge(node->getIndex(), edge.node->getIndex(), edge.color);
+    return output;
 }
 
 // for each segment, it computes the minimum and the maximum of all of its attachments,
 // using attachment notation based on the position in the cycle (0, ..., cycleSize-1)
-void EmbedderSefe::computeMinAndMaxSegmentsAttachments(const BicoloredSegmentsHandler& segmentsHandler,
-int segmentsMinMaxRedAttachment[][2], int segmentsMinMaxBlueAttachment[][2],
-bool segmentsHaveBetweenRedAttachment[], bool segmentsHaveBetweenBlueAttachment[]) const {
+void EmbedderSefe::computeMinAndMaxSegmentsAttachments(const IntersectionCycle* cycle,
+const BicoloredSegmentsHandler& segmentsHandler, int segmentsMinMaxRedAttachment[][2],
+int segmentsMinMaxBlueAttachment[][2], bool segmentsHaveBetweenRedAttachment[],
+bool segmentsHaveBetweenBlueAttachment[]) const {
     for (int i = 0; i < segmentsHandler.size(); i++) {
-        int minRed = segmentsHandler.getSegment(i)->size();
+        int minRed = cycle->size();
         int maxRed = -1;
-        int minBlue = segmentsHandler.getSegment(i)->size();
+        int minBlue = cycle->size();
         int maxBlue = -1;
-        const BicoloredSegment* segment = segmentsHandler.getSegment(i);
-        for (const NodeWithColors* attachment : segment->getAttachments()) {
-            const Color color = segment->getColorOfAttachment(attachment);
-            int index = attachment->getIndex();
+        for (int k = 0; k < segmentsHandler.getNumberOfAttachments(i); ++k) {
+            const Color color = segmentsHandler.getAttachmentColor(i, k);
+            int index = segmentsHandler.getAttachmentPosition(i, k);
             switch (color) {
                 case Color::RED:
                     if (index < minRed) minRed = index;
@@ -281,15 +339,15 @@ bool segmentsHaveBetweenRedAttachment[], bool segmentsHaveBetweenBlueAttachment[
         segmentsMinMaxBlueAttachment[i][1] = maxBlue;
         segmentsHaveBetweenRedAttachment[i] = false;
         segmentsHaveBetweenBlueAttachment[i] = false;
-        for (const NodeWithColors* attachment : segment->getAttachments()) {
-            int index = attachment->getIndex();
-            if (segment->isNodeRedAttachment(attachment)) {
+        for (int k = 0; k < segmentsHandler.getNumberOfAttachments(i); ++k) {
+            int index = segmentsHandler.getAttachmentPosition(i, k);
+            if (segmentsHandler.isAttachmentOfColor(i, k, Color::RED)) {
                 if (minRed < index && index < maxRed)
                     segmentsHaveBetweenRedAttachment[i] = true;
                 else
                     assert(index == minRed || index == maxRed);
             }
-            if (segment->isNodeBlueAttachment(attachment)) {
+            if (segmentsHandler.isAttachmentOfColor(i, k, Color::BLUE)) {
                 if (minBlue < index && index < maxBlue)
                     segmentsHaveBetweenBlueAttachment[i] = true;
                 else
@@ -303,51 +361,59 @@ bool segmentsHaveBetweenRedAttachment[], bool segmentsHaveBetweenBlueAttachment[
 
 const EmbeddingSefe* EmbedderSefe::mergeSegmentsEmbeddings(const BicoloredSubGraph* graph, const IntersectionCycle* cycle,
 const std::vector<std::unique_ptr<const EmbeddingSefe>>& embeddings, const BicoloredSegmentsHandler& segmentsHandler,
-const std::vector<int>& bipartition) const {
-    EmbeddingSefe* output = new EmbeddingSefe(graph);
+const std::vector<int>& bipartition, std::pmr::memory_resource* resource) const {
+    EmbeddingSefe* output = new EmbeddingSefe(graph, resource);
     int segmentsMinMaxRedAttachment[segmentsHandler.size()][2];
     int segmentsMinMaxBlueAttachment[segmentsHandler.size()][2];
     bool segmentsHaveBetweenRedAttachment[segmentsHandler.size()]; // true if segment has a red attachment between its min and max red attachments
     bool segmentsHaveBetweenBlueAttachment[segmentsHandler.size()]; // true if segment has a blue attachment between its min and max blue attachments
-    computeMinAndMaxSegmentsAttachments(segmentsHandler, segmentsMinMaxRedAttachment, segmentsMinMaxBlueAttachment,
+    computeMinAndMaxSegmentsAttachments(cycle, segmentsHandler, segmentsMinMaxRedAttachment, segmentsMinMaxBlueAttachment,
         segmentsHaveBetweenRedAttachment, segmentsHaveBetweenBlueAttachment);
     std::vector<bool> isSegmentCompatible = compatibilityEmbeddingsAndCycle(graph, cycle, embeddings, segmentsHandler);
+    // the embeddings of the segments outside the cycle are mirrored, once for all their attachments
+    for (int i = 0; i < segmentsHandler.size(); ++i)
+        if (bipartition[i] == 1) isSegmentCompatible[i] = !isSegmentCompatible[i];
     for (int cycleNodePosition = 0; cycleNodePosition < cycle->size(); ++cycleNodePosition) {
         std::vector<int> insideSegments{};
         std::vector<int> outsideSegments{};
-        for (int i = 0; i < segmentsHandler.size(); ++i) {
-            const NodeWithColors* node = segmentsHandler.getSegment(i)->getNode(cycleNodePosition);
-            if (segmentsHandler.getSegment(i)->isNodeAnAttachment(node)) {
-                if (bipartition[i] == 0) insideSegments.push_back(i);
-                else outsideSegments.push_back(i);
-            }
+        for (int k = 0; k < segmentsHandler.getNumberOfSegmentsAttachedAt(cycleNodePosition); ++k) {
+            const int i = segmentsHandler.getSegmentAttachedAt(cycleNodePosition, k);
+            if (bipartition[i] == 0) insideSegments.push_back(i);
+            else outsideSegments.push_back(i);
         }
         const NodeWithColors* cycleNode = cycle->getNode(cycleNodePosition);
         const NodeWithColors* prevCycleNode = cycle->getPrevOfNode(cycleNode);
         const NodeWithColors* nextCycleNode = cycle->getNextOfNode(cycleNode);
         // order of the segments inside the cycle
-        std::vector<int> insideOrder = computeOrder(cycleNode, insideSegments, segmentsMinMaxRedAttachment, segmentsMinMaxBlueAttachment,
+        std::vector<int> insideOrder = computeOrder(insideSegments, segmentsMinMaxRedAttachment, segmentsMinMaxBlueAttachment,
             segmentsHandler, cycleNodePosition, segmentsHaveBetweenRedAttachment, segmentsHaveBetweenBlueAttachment);
         reverseVector(insideOrder);
         // order of the segments outside the cycle
-        std::vector<int> outsideOrder = computeOrder(cycleNode, outsideSegments, segmentsMinMaxRedAttachment, segmentsMinMaxBlueAttachment,
+        std::vector<int> outsideOrder = computeOrder(outsideSegments, segmentsMinMaxRedAttachment, segmentsMinMaxBlueAttachment,
             segmentsHandler, cycleNodePosition, segmentsHaveBetweenRedAttachment, segmentsHaveBetweenBlueAttachment);
-        for (int index : outsideOrder)
-            isSegmentCompatible[index] = !isSegmentCompatible[index];
         output->addSingleEdge(cycleNode->getIndex(), nextCycleNode->getIndex(), Color::BLACK);
         for (int i = 0; i < insideOrder.size(); ++i) {
+            if (segmentsHandler.isChord(insideOrder[i])) {
+                addChordEdge(segmentsHandler.getChord(insideOrder[i]), cycle, cycleNodePosition, output);
+                continue;
+            }
             const BicoloredSegment* segment = segmentsHandler.getSegment(insideOrder[i]);
             const EmbeddingSefe* embedding = embeddings[insideOrder[i]].get();
             addMiddleEdges(segment, embedding, cycleNodePosition, graph, isSegmentCompatible[insideOrder[i]], output);
         }
         output->addSingleEdge(cycleNode->getIndex(), prevCycleNode->getIndex(), Color::BLACK);
         for (int i = 0; i < outsideOrder.size(); ++i) {
+            if (segmentsHandler.isChord(outsideOrder[i])) {
+                addChordEdge(segmentsHandler.getChord(outsideOrder[i]), cycle, cycleNodePosition, output);
+                continue;
+            }
             const BicoloredSegment* segment = segmentsHandler.getSegment(outsideOrder[i]);
             const EmbeddingSefe* embedding = embeddings[outsideOrder[i]].get();
             addMiddleEdges(segment, embedding, cycleNodePosition, graph, isSegmentCompatible[outsideOrder[i]], output);
         }
     }
     for (int i = 0; i < segmentsHandler.size(); ++i) {
+        if (segmentsHandler.isChord(i)) continue; // chords have no nodes outside the cycle
         const BicoloredSegment* segment = segmentsHandler.getSegment(i);
         const EmbeddingSefe* embedding = embeddings[i].get();
         for (int nodeIndex = 0; nodeIndex < segment->size(); ++nodeIndex) {
@@ -376,6 +442,16 @@ const std::vector<int>& bipartition) const {
     return output;
 }
 
+// a chord has a single edge at each endpoint, so only its place among the segments
+// at the endpoint matters
+void EmbedderSefe::addChordEdge(const BicoloredChord& chord, const IntersectionCycle* cycle, int cycleNodePosition,
+EmbeddingSefe* output) const {
+    assert(chord.from == cycleNodePosition || chord.to == cycleNodePosition);
+    const int otherPosition = chord.from == cycleNodePosition ? chord.to : chord.from;
+    output->addSingleEdge(cycle->getNode(cycleNodePosition)->getIndex(), cycle->getNode(otherPosition)->getIndex(),
+        chord.color);
+}
+
 void EmbedderSefe::addMiddleEdges(const BicoloredSegment* segment, const EmbeddingSefe* embedding, int cycleNodeIndex,
 const BicoloredSubGraph* higherLevel, bool compatible, EmbeddingSefe* output) const {
     const IntersectionCycle* cycle = segment->getOriginalCycle();
@@ -386,7 +462,7 @@ const BicoloredSubGraph* higherLevel, bool compatible, EmbeddingSefe* output) co
     assert(prevCycleNode->getBicoloredGraph() == higherLevel);
     assert(nextCycleNode->getBicoloredGraph() == higherLevel);
     assert(segment->isNodeAnAttachment(segment->getNode(cycleNodeIndex)));
-    const std::vector<Edge>& edges = embedding->getNode(cycleNodeIndex)->getEdges();
+    const EdgesRange edges = embedding->getNode(cycleNodeIndex)->getEdges();
     int positionOfLastAddedNode = -1;
     for (int i = 0; i < edges.size(); ++i) {
         const NodeWithColors* neighbor = edges[i].node;
@@ -432,11 +508,16 @@ const BicoloredSubGraph* higherLevel, bool compatible, EmbeddingSefe* output) co
 }
 
 // the embedding is "compatible" with the cycle if, drawn the cycle clockwise,
-// the embedding of the segment places the segment inside the cycle
+// the embedding of the segment places the segment inside the cycle;
+// chords have no embedding and are considered compatible
 std::vector<bool> EmbedderSefe::compatibilityEmbeddingsAndCycle(const BicoloredSubGraph* component, const IntersectionCycle* cycle,
 const std::vector<std::unique_ptr<const EmbeddingSefe>>& embeddings, const BicoloredSegmentsHandler& segmentsHandler) const {
     std::vector<bool> isCompatible(segmentsHandler.size());
     for (int i = 0; i < segmentsHandler.size(); ++i) {
+        if (segmentsHandler.isChord(i)) {
+            isCompatible[i] = true;
+            continue;
+        }
         const BicoloredSegment* segment = segmentsHandler.getSegment(i);
         const EmbeddingSefe* embedding = embeddings[i].get();
         const NodeWithColors* attachment = segment->getAttachments()[0]; // any attachment is good
@@ -445,7 +526,7 @@ const std::vector<std::unique_ptr<const EmbeddingSefe>>& embeddings, const Bicol
         const NodeWithColors* prev = cycle->getPrevOfNode(higherLevelNode);
         int position = -1;
         int attachmentIndex = attachment->getIndex();
-        const std::vector<Edge>& edges = embedding->getNode(attachmentIndex)->getEdges();
+        const EdgesRange edges = embedding->getNode(attachmentIndex)->getEdges();
         assert(edges.size() >= 3);
         for (int j = 0; j < edges.size(); ++j) {
             const NodeWithColors* neighbor = edges[j].node;
@@ -466,8 +547,7 @@ const std::vector<std::unique_ptr<const EmbeddingSefe>>& embeddings, const Bicol
 // returns 1 if the first segment goes after the second,
 // returns 0 if they can go in any order
 // (considering the segments to be placed outside the cycle)
-int compareSegments(const NodeWithColors* cycleNode, const BicoloredSegment* segment1, const BicoloredSegment* segment2,
-int segmentsMinMaxAttachment[][2], int segment1index, int segment2index,
+int compareSegments(int segmentsMinMaxAttachment[][2], int segment1index, int segment2index,
 int cycleNodePosition, bool segmentsHasBetweenAttachment[]) {
     int seg1min = segmentsMinMaxAttachment[segment1index][0];
     int seg1max = segmentsMinMaxAttachment[segment1index][1];
@@ -547,28 +627,120 @@ int segmentsMinMaxRedAttachment[][2], int segmentsMinMaxBlueAttachment[][2], int
     return change;
 }
 
+// position of a segment at the cycle node in one color, a key consistent with compareSegments
+// when the node is between the min and the max attachment of the segment in that color: first
+// the segments whose max attachment is the node (by decreasing min attachment, the one with an
+// attachment in between first), then the one passing through it, then the ones whose min
+// attachment is the node (by decreasing max attachment, the one with an attachment in between last)
+static std::tuple<int, int, bool> computeSegmentKey(int segmentsMinMaxAttachment[][2], int segmentIndex,
+int cycleNodePosition, bool segmentsHasBetweenAttachment[]) {
+    const int min = segmentsMinMaxAttachment[segmentIndex][0];
+    const int max = segmentsMinMaxAttachment[segmentIndex][1];
+    const bool hasBetween = segmentsHasBetweenAttachment[segmentIndex];
+    assert(min <= cycleNodePosition && cycleNodePosition <= max);
+    if (cycleNodePosition == min) return {2, -max, hasBetween};
+    if (cycleNodePosition == max) return {0, -min, !hasBetween};
+    return {1, 0, false};
+}
+
 // assuming the cycle is drawn CLOCKWISE, and assuming the segments incident to the
 // attachment "cycleNode" must be drawn OUTSIDE the cycle, computes the order of
-// placement of these segments such that they don't intersect
-std::vector<int> EmbedderSefe::computeOrder(const NodeWithColors* cycleNode, const std::vector<int>& segmentsIndexes,
+// placement of these segments such that they don't intersect.
+// segments are compared on their red attachments, then on their blue ones, and the
+// remaining draws are broken by index. if the node is between the min and the max
+// attachment of every segment in each color it has attachments of, the segments with
+// red attachments are sorted by (red key, blue key, index, decreasing if the node is a
+// min attachment), the ones with blue attachments by (blue key, red key, index), and
+// the two orders are merged in O(k log k), the segments of a single color being
+// compared only on it; otherwise, or if the two orders disagree on the segments of
+// both colors, compareSegments may not be transitive, and the segments are ordered by
+// selection, in O(k^2)
+std::vector<int> EmbedderSefe::computeOrder(const std::vector<int>& segmentsIndexes,
 int segmentsMinMaxRedAttachment[][2], int segmentsMinMaxBlueAttachment[][2], const BicoloredSegmentsHandler& segmentsHandler,
 int cycleNodePosition, bool segmentsHasBetweenRedAttachment[], bool segmentsHasBetweenBlueAttachment[]) const {
     std::vector<int> order(segmentsIndexes);
+    // a segment with no attachment of a color has max attachment -1 in that color
+    auto hasAttachments = [](int segmentsMinMaxAttachment[][2], int segmentIndex) {
+        return segmentsMinMaxAttachment[segmentIndex][1] != -1;
+    };
+    auto isAround = [cycleNodePosition](int segmentsMinMaxAttachment[][2], int segmentIndex) {
+        return segmentsMinMaxAttachment[segmentIndex][0] <= cycleNodePosition &&
+            cycleNodePosition <= segmentsMinMaxAttachment[segmentIndex][1];
+    };
+    const bool hasKeys = std::all_of(order.begin(), order.end(), [&](int segmentIndex) {
+        return (!hasAttachments(segmentsMinMaxRedAttachment, segmentIndex) || isAround(segmentsMinMaxRedAttachment, segmentIndex)) &&
+            (!hasAttachments(segmentsMinMaxBlueAttachment, segmentIndex) || isAround(segmentsMinMaxBlueAttachment, segmentIndex));
+    });
+    if (hasKeys) {
+        // the key of a color the segment has no attachments of only breaks draws, as a segment through the node
+        auto computeColorKey = [&](int segmentsMinMaxAttachment[][2], bool segmentsHasBetweenAttachment[], int segmentIndex) {
+            if (!hasAttachments(segmentsMinMaxAttachment, segmentIndex)) return std::make_tuple(1, 0, false);
+            return computeSegmentKey(segmentsMinMaxAttachment, segmentIndex, cycleNodePosition, segmentsHasBetweenAttachment);
+        };
+        auto computeIndexKey = [&](int segmentIndex) {
+            const bool isMin = segmentsMinMaxRedAttachment[segmentIndex][0] == cycleNodePosition ||
+                segmentsMinMaxBlueAttachment[segmentIndex][0] == cycleNodePosition;
+            return isMin ? -segmentIndex : segmentIndex;
+        };
+        auto computeRedKey = [&](int segmentIndex) {
+            return std::make_tuple(computeColorKey(segmentsMinMaxRedAttachment, segmentsHasBetweenRedAttachment, segmentIndex),
+                computeColorKey(segmentsMinMaxBlueAttachment, segmentsHasBetweenBlueAttachment, segmentIndex),
+                computeIndexKey(segmentIndex));
+        };
+        auto computeBlueKey = [&](int segmentIndex) {
+            return std::make_tuple(computeColorKey(segmentsMinMaxBlueAttachment, segmentsHasBetweenBlueAttachment, segmentIndex),
+                computeColorKey(segmentsMinMaxRedAttachment, segmentsHasBetweenRedAttachment, segmentIndex),
+                computeIndexKey(segmentIndex));
+        };
+        std::vector<int> redOrder{};
+        std::vector<int> blueOrder{};
+        for (int segmentIndex : order) {
+            assert(hasAttachments(segmentsMinMaxRedAttachment, segmentIndex) || hasAttachments(segmentsMinMaxBlueAttachment, segmentIndex));
+            if (hasAttachments(segmentsMinMaxRedAttachment, segmentIndex)) redOrder.push_back(segmentIndex);
+            if (hasAttachments(segmentsMinMaxBlueAttachment, segmentIndex)) blueOrder.push_back(segmentIndex);
+        }
+        std::sort(redOrder.begin(), redOrder.end(), [&](int segment1, int segment2) {
+            return computeRedKey(segment1) < computeRedKey(segment2);
+        });
+        if (redOrder.size() == order.size()) return redOrder;
+        std::sort(blueOrder.begin(), blueOrder.end(), [&](int segment1, int segment2) {
+            return computeBlueKey(segment1) < computeBlueKey(segment2);
+        });
+        // the segments of a single color are taken as soon as they are reached, the
+        // ones of both colors must be reached at the same time in the two orders
+        std::vector<int> mergedOrder{};
+        int redPosition = 0;
+        int bluePosition = 0;
+        bool isConsistent = true;
+        while (isConsistent && mergedOrder.size() < order.size()) {
+            if (redPosition < redOrder.size() && !hasAttachments(segmentsMinMaxBlueAttachment, redOrder[redPosition])) {
+                mergedOrder.push_back(redOrder[redPosition++]);
+                continue;
+            }
+            if (bluePosition < blueOrder.size() && !hasAttachments(segmentsMinMaxRedAttachment, blueOrder[bluePosition])) {
+                mergedOrder.push_back(blueOrder[bluePosition++]);
+                continue;
+            }
+            isConsistent = redPosition < redOrder.size() && bluePosition < blueOrder.size() &&
+                redOrder[redPosition] == blueOrder[bluePosition];
+            if (!isConsistent) break;
+            mergedOrder.push_back(redOrder[redPosition++]);
+            ++bluePosition;
+        }
+        if (isConsistent) return mergedOrder;
+    }
     for (int i = 0; i < int(order.size())-1; ++i) {
         int min = i;
-        const BicoloredSegment* minSegment = segmentsHandler.getSegment(order[min]);
         for (int j = i+1; j < order.size(); ++j) {
-            const BicoloredSegment* segmentCandidate = segmentsHandler.getSegment(order[j]);
-            int v = compareSegments(cycleNode, minSegment, segmentCandidate, segmentsMinMaxRedAttachment,
-                order[min], order[j], cycleNodePosition, segmentsHasBetweenRedAttachment);
+            int v = compareSegments(segmentsMinMaxRedAttachment, order[min], order[j], cycleNodePosition,
+                segmentsHasBetweenRedAttachment);
             if (v == 0)
-                v = compareSegments(cycleNode, minSegment, segmentCandidate, segmentsMinMaxBlueAttachment,
-                    order[min], order[j], cycleNodePosition, segmentsHasBetweenBlueAttachment);
+                v = compareSegments(segmentsMinMaxBlueAttachment, order[min], order[j], cycleNodePosition,
+                    segmentsHasBetweenBlueAttachment);
             if (v < 0)
                 continue;
             if (v > 0) {
                 min = j;
-                minSegment = segmentsHandler.getSegment(order[min]);
                 continue;
             }
             assert(!segmentsHasBetweenBlueAttachment[order[min]]);
@@ -579,7 +751,6 @@ int cycleNodePosition, bool segmentsHasBetweenRedAttachment[], bool segmentsHasB
                 segmentsMinMaxBlueAttachment, order[j], order[min]);
             if (changeMinSegment) {
                 min = j;
-                minSegment = segmentsHandler.getSegment(order[min]);
             }
         }
         int temp = order[min];
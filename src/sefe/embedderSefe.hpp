@@ -3,42 +3,59 @@
 
 #include <optional>
 #include <vector>
+#include <memory_resource>
 
 #include "../basic/graph.hpp"
 #include "bicoloredGraph.hpp"
 #include "bicoloredSegment.hpp"
 #include "intersectionCycle.hpp"
 #include "../auslander-parter/embedder.hpp"
+#include "../auslander-parter/blockCutTree.hpp"
 
 class EmbeddingSefe : public BicoloredSubGraph {
 public:
-    EmbeddingSefe(const BicoloredSubGraph* originalGraph);
-    EmbeddingSefe(const BicoloredGraph* originalGraph);
+    EmbeddingSefe(const BicoloredSubGraph* originalGraph,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    EmbeddingSefe(const BicoloredGraph* originalGraph,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     void addSingleEdge(int fromIndex, int toIndex, Color color);
     void addSingleEdge(NodeWithColors* from, const NodeWithColors* to, Color color);
     const Embedding* computeRedEmbedding(const Graph* red) const;
     const Embedding* computeBlueEmbedding(const Graph* blue) const;
 };
 
+// the segments of a graph, and their embeddings, are allocated from a monotonic arena owned by
+// the recursive call on that graph, released once they are merged; the graph given to the
+// recursion lives in an arena of the public call, and only the returned embedding uses the default heap;
+// the overloads taking the block-cut tree of the intersection reuse it for the biconnectivity check;
+// the depth reached by the recursion of a public call is reported in the counters it is given;
+// the first cycle of each graph and segment is always the one found by IntersectionCycle: the
+// cycle selections of Embedder are not offered, since with longer cycles the segments more
+// often conflict in ways that the interlacement of InterlacementGraphSefe does not capture
 class EmbedderSefe {
 private:
-    bool testSefe(const BicoloredSubGraph* bicoloredGraph, IntersectionCycle* cycle) const;
-    void makeCycleGood(IntersectionCycle* cycle, const BicoloredSegment* segment) const;
+    bool testSefe(const BicoloredSubGraph* bicoloredGraph, IntersectionCycle* cycle, const int depth,
+        RecursionCounters& counters) const;
+    BicoloredSegmentsHandler makeCycleGood(const BicoloredSubGraph* graph, IntersectionCycle* cycle,
+        const BicoloredSegmentsHandler& segmentsHandler, std::pmr::memory_resource* resource) const;
     const EmbeddingSefe* baseCaseGraph(const BicoloredGraph* graph) const;
-    std::optional<const EmbeddingSefe*> embedGraph(const BicoloredSubGraph* graph) const;
+    const EmbeddingSefe* copyEmbedding(const BicoloredGraph* graph, const EmbeddingSefe* embedding) const;
     std::optional<const EmbeddingSefe*> embedGraph(const BicoloredSubGraph* graph,
-        IntersectionCycle* cycle) const;
-    const EmbeddingSefe* baseCaseCycle(const BicoloredSubGraph* cycle) const;
-    const EmbeddingSefe* baseCasePath(const BicoloredSubGraph* component, const IntersectionCycle* cycle) const;
+        std::pmr::memory_resource* resource, const int depth, RecursionCounters& counters) const;
+    std::optional<const EmbeddingSefe*> embedGraph(const BicoloredSubGraph* graph, IntersectionCycle* cycle,
+        std::pmr::memory_resource* resource, const int depth, RecursionCounters& counters) const;
+    const EmbeddingSefe* baseCaseCycle(const BicoloredSubGraph* cycle, std::pmr::memory_resource* resource) const;
+    const EmbeddingSefe* baseCasePath(const BicoloredSubGraph* component, const IntersectionCycle* cycle,
+        std::pmr::memory_resource* resource) const;
     const EmbeddingSefe* mergeSegmentsEmbeddings(const BicoloredSubGraph* graph, const IntersectionCycle* cycle,
         const std::vector<std::unique_ptr<const EmbeddingSefe>>& embeddings, const BicoloredSegmentsHandler& segmentsHandler,
-        const std::vector<int>& bipartition) const;
-    void computeMinAndMaxSegmentsAttachments(const BicoloredSegmentsHandler& segmentsHandler,
+        const std::vector<int>& bipartition, std::pmr::memory_resource* resource) const;
+    void computeMinAndMaxSegmentsAttachments(const IntersectionCycle* cycle, const BicoloredSegmentsHandler& segmentsHandler,
         int segmentsMinMaxRedAttachment[][2], int segmentsMinMaxBlueAttachment[][2],
         bool segmentsHaveBetweenRedAttachment[], bool segmentsHaveBetweenBlueAttachment[]) const;
     std::vector<bool> compatibilityEmbeddingsAndCycle(const BicoloredSubGraph* component, const IntersectionCycle* cycle,
     const std::vector<std::unique_ptr<const EmbeddingSefe>>& embeddings, const BicoloredSegmentsHandler& segmentsHandler) const;
-    std::vector<int> computeOrder(const NodeWithColors* cycleNode, const std::vector<int>& segmentsIndexes,
+    std::vector<int> computeOrder(const std::vector<int>& segmentsIndexes,
         int segmentsMinMaxRedAttachment[][2], int segmentsMinMaxBlueAttachment[][2],
         const BicoloredSegmentsHandler& segmentsHandler, int cycleNodePosition,
         bool segmentsHaveBetweenRedAttachment[], bool segmentsHaveBetweenBlueAttachment[]) const;
@@ -46,9 +63,15 @@ private:
         int segmentsMinMaxRedAttachment[][2], int segmentsMinMaxBlueAttachment[][2], int segmentIndex1, int segmentIndex2) const;
     void addMiddleEdges(const BicoloredSegment* segment, const EmbeddingSefe* embedding, int cycleNodeIndex,
         const BicoloredSubGraph* higherLevel, bool compatible, EmbeddingSefe* output) const;
+    void addChordEdge(const BicoloredChord& chord, const IntersectionCycle* cycle, int cycleNodePosition,
+        EmbeddingSefe* output) const;
 public:
-    bool testSefe(const Graph* graph1, const Graph* graph2) const;
-    std::optional<const EmbeddingSefe*> embedGraph(const BicoloredGraph* graph) const;
+    bool testSefe(const Graph* graph1, const Graph* graph2, RecursionCounters* counters = nullptr) const;
+    bool testSefe(const BicoloredGraph* graph, const BlockCutTree& intersectionTree,
+        RecursionCounters* counters = nullptr) const;
+    std::optional<const EmbeddingSefe*> embedGraph(const BicoloredGraph* graph, RecursionCounters* counters = nullptr) const;
+    std::optional<const EmbeddingSefe*> embedGraph(const BicoloredGraph* graph,
+        const BlockCutTree& intersectionTree, RecursionCounters* counters = nullptr) const;
 };
 
 #endif
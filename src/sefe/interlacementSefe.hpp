@@ -1,21 +1,27 @@
 #ifndef MY_INTERLACEMENT_SEFE_H
 #define MY_INTERLACEMENT_SEFE_H
 
-#include "../basic/graph.hpp"
+#include <optional>
+#include <vector>
+
 #include "bicoloredSegment.hpp"
 #include "intersectionCycle.hpp"
+#include "../auslander-parter/interlacement.hpp"
 
-class InterlacementGraphSefe : public Graph {
+// two segments are in conflict if they are interlaced considering only their red
+// attachments, or only their blue ones (black attachments are both red and blue);
+// the conflicts of each color are found with an InterlacementSweep and fed straight
+// into a ParityUnionFind, so the interlacement graph is never built
+class InterlacementGraphSefe {
 private:
     const IntersectionCycle* cycle_m;
     const BicoloredSegmentsHandler* segmentsHandler_m;
 
-    bool areInConflict(const BicoloredSegment* segment1, const BicoloredSegment* segment2,
-        const int cycleLabels[], const Color color, const int numberOfAttachments);
-    void computeConflicts();
-    void computeCycleLabels(const BicoloredSegment* segment, int cycleLabels[], Color color, int& numberOfColoredAttachments);
+    bool isCycleSimple() const;
+    bool addInterlacedPairs(const Color color, ParityUnionFind& unionFind) const;
 public:
     InterlacementGraphSefe(const IntersectionCycle* cycle, const BicoloredSegmentsHandler* segmentsHandler);
+    std::optional<std::vector<int>> computeBipartition() const;
 };
 
 #endif
@@ -1,53 +1,51 @@
 #include "intersectionCycle.hpp"
 
+#include <algorithm>
 #include <cassert>
 
 // assumes intersection of graph is biconnected
 IntersectionCycle::IntersectionCycle(const BicoloredSubGraph* graph)
 : graph_m(graph) {
-    int size = graph->size();
-    bool isNodeVisited[size];
-    for (int node = 0; node < size; ++node)
-        isNodeVisited[node] = false;
-    posInCycle_m.resize(size);
-    for (int i = 0; i < size; ++i)
-        posInCycle_m[i] = -1;
-    dfsBuildCycle(graph->getNode(0), isNodeVisited, nullptr);
-    cleanupCycle();
-    int index = 0;
-    for (const NodeWithColors* node : nodes_m)
-        posInCycle_m[node->getIndex()] = index++;
+    posInCycle_m.assign(graph->size(), -1);
+    buildCycle(graph->getNode(0));
 }
 
-void IntersectionCycle::dfsBuildCycle(const NodeWithColors* node, bool isNodeVisited[], const NodeWithColors* prev) {
-    nodes_m.push_back(node);
-    isNodeVisited[node->getIndex()] = true;
-    for (const Edge& edge : node->getEdges()) {
-        const NodeWithColors* neighbor = edge.node;
-        if (neighbor == prev)
-            continue;
-        if (edge.color != Color::BLACK)
-            continue;
-        if (!isNodeVisited[neighbor->getIndex()]) {
-            dfsBuildCycle(neighbor, isNodeVisited, node);
-            break;
-        }
-        nodes_m.push_back(neighbor);
-        return;
+// walks the black edges from start, always moving to the first black neighbor that is not the
+// node it comes from, until it reaches an already visited node, which closes the cycle;
+// the walk is written directly in nodes_m (with positions in posInCycle_m), then the leading
+// nodes that are not in the cycle are removed in place and the closing node goes last
+// (walk [1, 2, 3, 4, 5] with 5 leading back to 3 gives cycle [4, 5, 3]);
+// if the walk reaches a node with no other black neighbor, the cycle is empty
+void IntersectionCycle::buildCycle(const NodeWithColors* start) {
+    const NodeWithColors* prev = nullptr;
+    const NodeWithColors* node = start;
+    const NodeWithColors* closingNode = nullptr;
+    while (closingNode == nullptr) {
+        posInCycle_m[node->getIndex()] = nodes_m.size();
+        nodes_m.push_back(node);
+        const NodeWithColors* next = nullptr;
+        for (const Edge& edge : node->getEdges())
+            if (edge.node != prev && edge.color == Color::BLACK) {
+                next = edge.node;
+                break;
+            }
+        if (next == nullptr) break;
+        if (posInCycle_m[next->getIndex()] != -1)
+            closingNode = next;
+        prev = node;
+        node = next;
     }
-}
-
-// removes leading nodes of the list that do not partecipate in the cycle
-// assumes starting node of the cycle is contained twice
-// (at the start and at the end of the actual cycle)
-void IntersectionCycle::cleanupCycle() {
-    std::vector<const NodeWithColors*> copy(nodes_m);
-    nodes_m.clear();
-    bool foundEnd{false};
-    for (int i = 0; i < copy.size(); ++i) {
-        if (foundEnd) nodes_m.push_back(copy[i]);
-        else if (copy[i] == copy.back()) foundEnd = true;
+    const int firstPosition = closingNode == nullptr ? nodes_m.size() : posInCycle_m[closingNode->getIndex()];
+    for (int i = 0; i < firstPosition; ++i)
+        posInCycle_m[nodes_m[i]->getIndex()] = -1;
+    if (closingNode == nullptr) {
+        nodes_m.clear();
+        return;
     }
+    std::rotate(nodes_m.begin()+firstPosition, nodes_m.begin()+firstPosition+1, nodes_m.end());
+    nodes_m.erase(nodes_m.begin(), nodes_m.begin()+firstPosition);
+    for (int i = 0; i < nodes_m.size(); ++i)
+        posInCycle_m[nodes_m[i]->getIndex()] = i;
 }
 
 // the list of nodes must contain, at the end, a node contained in the cycle
@@ -12,8 +12,7 @@ private:
     std::vector<const NodeWithColors*> nodes_m{};
     std::vector<int> posInCycle_m{};
     const BicoloredSubGraph* graph_m;
-    void dfsBuildCycle(const NodeWithColors* node, bool isNodeVisited[], const NodeWithColors* prev);
-    void cleanupCycle();
+    void buildCycle(const NodeWithColors* start);
     void nextIndex(int& index);
 public:
     IntersectionCycle(const BicoloredSubGraph* graph);